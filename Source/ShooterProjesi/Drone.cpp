@@ -1,319 +1,579 @@
-
-
-#include "Drone.h"
-#include "GameFramework/SpringArmComponent.h"
-#include "Camera/CameraComponent.h"
-#include "Kismet/KismetMathLibrary.h"
-#include "ShooterCharacter.h"
-#include "Engine/StaticMeshSocket.h"
-#include "Particles/ParticleSystemComponent.h"
-#include "Kismet/GameplayStatics.h"
-#include "Sound/SoundCue.h"
-
-
-// Sets default values
-ADrone::ADrone()
-{
- 	// Set this pawn to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
-
-	DroneMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("DroneMesh"));
-	SetRootComponent(DroneMesh);
-	DroneMesh->SetSimulatePhysics(true);
-	DroneMesh->SetLinearDamping(1.f);
-	DroneMesh->SetAngularDamping(1.f);
-	DroneMesh->SetEnableGravity(false);
-
-	SpringArm = CreateDefaultSubobject<USpringArmComponent>(TEXT("SpringArm"));
-	SpringArm->SetupAttachment(DroneMesh);
-	SpringArm->SocketOffset= FVector(0.f, 0.f, 180.f);
-	SpringArm->SetUsingAbsoluteRotation(true);
-	SpringArm->TargetArmLength = 250.f;
-
-	Camera = CreateDefaultSubobject<UCameraComponent>(TEXT("Camera"));
-	Camera->SetupAttachment(SpringArm, USpringArmComponent::SocketName);
-
-	MoveForwardValue=0.f;
-	MoveRightValue=0.f;
-	MoveUpValue=0.f;
-
-	MovementSpeed = 200.f;
-	CameraSpeed = 7.f;
-
-	BaseTurnRate = 45.f;
-	BaseLookUpRate = 45.f;
-
-	bIsBoostReady = true;
-
-
-
-}
-
-// Called when the game starts or when spawned
-void ADrone::BeginPlay()
-{
-	Super::BeginPlay();
-	
-}
-
-
-void ADrone::MoveForward(float Value)
-{
-	MoveForwardValue = Value;
-	DroneMovement();
-}
-
-void ADrone::MoveRight(float Value)
-{
-	MoveRightValue = Value;
-	DroneMovement();
-}
-
-void ADrone::MoveUp(float Value)
-{
-	MoveUpValue = Value;
-	DroneMovement();
-}
-
-// Update actor's velocity based on MoveForwardValue, MoveRightValue, MoveUpValue
-void ADrone::DroneMovement()
-{
-	FVector MadeVector = UKismetMathLibrary::MakeVector(MoveForwardValue, MoveRightValue, MoveUpValue);
-	FRotator MadeRotator = FRotator(0.f, Camera->GetComponentRotation().Yaw, 0.f);
-
-	MadeVector = MadeRotator.RotateVector(MadeVector);
-
-	MadeVector = MadeVector * MovementSpeed *  UGameplayStatics::GetWorldDeltaSeconds(GetWorld());
-
-	MadeVector = MadeVector + GetVelocity();
-
-	DroneMesh->SetPhysicsLinearVelocity(MadeVector);
-
-	
-	
-}
-
-// Rotate spring arm component
-void ADrone::UpdateSpringArm()
-{
-	FRotator SpringRotation = SpringArm->GetComponentRotation();
-	float SpringArmYaw = SpringRotation.Yaw;
-	float SpringArmPitch = SpringRotation.Pitch;
-
-	float RotatorPitch = (CameraSpeed * (-1.f) * LookUpValue) + SpringArmPitch;
-	RotatorPitch =	UKismetMathLibrary::ClampAngle(RotatorPitch,-45.f, 85.f);
-	
-
-	float RotatorYaw = (TurnValue * CameraSpeed) + SpringArmYaw;
-
-	FRotator SpringArmTargetRotation  = UKismetMathLibrary::MakeRotator(0.f, RotatorPitch, RotatorYaw);
-	
-
-	SpringArm->SetWorldRotation(UKismetMathLibrary::RInterpTo(SpringRotation, SpringArmTargetRotation, UGameplayStatics::GetWorldDeltaSeconds(GetWorld()), 8.f));
-
-
-
-	
-
-}
-
-// Rotate camera to drone
-void ADrone::RotateCameraFocus()
-{
-	FRotator LookAtRotation = UKismetMathLibrary::FindLookAtRotation(Camera->GetComponentLocation(), GetActorLocation());
-	Camera->SetWorldRotation(UKismetMathLibrary::RInterpTo(Camera->GetComponentRotation(), LookAtRotation, UGameplayStatics::GetWorldDeltaSeconds(GetWorld()), 2.f)) ;
-
-
-	FRotator ActorNewRotation = UKismetMathLibrary::MakeRotator((MoveRightValue * (20.f)), (MoveForwardValue * (-7.f)), LookAtRotation.Yaw);
-	ActorNewRotation = UKismetMathLibrary::RInterpTo(GetActorRotation(), ActorNewRotation, UGameplayStatics::GetWorldDeltaSeconds(GetWorld()), 4.f);
-	
-	SetActorRotation(ActorNewRotation);
-}
-
-// Update camera fiel of view based on drone's velocity
-void ADrone::UpdateCameraFOV()
-{
-	float VelocityLen = GetVelocity().Length();
-
-	VelocityLen = UKismetMathLibrary::MapRangeUnclamped(VelocityLen, 300.f, 1'000.f, 75.f, 110.f);
-	VelocityLen = UKismetMathLibrary::Clamp(VelocityLen, 75.f, 110.f);
-
-	float FOV =	UKismetMathLibrary::FInterpTo(Camera->FieldOfView, VelocityLen, UGameplayStatics::GetWorldDeltaSeconds(GetWorld()), 8.f);
-
-	Camera->SetFieldOfView(FOV);
-	
-
-}
-
-// Small dash based on drone's velocity 
-void ADrone::DroneDash()
-{
-	if (bIsBoostReady)
-	{
-		bIsBoostReady = false;
-		
-		FVector BoostVector = GetVelocity() * 2.f;
-		DroneMesh->SetPhysicsLinearVelocity(BoostVector);
-		GetWorldTimerManager().SetTimer(BoostTimer, this, &ADrone::SetBoostState, 5.f);
-	
-	}
-
-
-
-}
-
-void ADrone::SetBoostState()
-{
-	if (!bIsBoostReady)
-	{
-		bIsBoostReady = true;
-	}
-}
-
-void ADrone::Fire()
-{
-	if (FireSound)
-	{
-		UGameplayStatics::PlaySound2D(this, FireSound);
-	}
-
-	const FTransform SocketTransform = DroneMesh->GetSocketTransform("DroneBarrel");
-
-	FVector BeamEnd;
-	bool bBeamEnd = GetBeamEndLocation(SocketTransform.GetLocation(), BeamEnd);
-
-	if (bBeamEnd)
-	{
-		// Spawn impact particles after updating BeamEndPoint
-		if (ImpactParticle)
-		{
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticle, BeamEnd);
-		}
-
-
-	}
-}
-
-bool ADrone::GetBeamEndLocation(const FVector & DroneSocketLocation, FVector & EndLocation)
-{
-
-
-	// Get Viewport Size
-	FVector2D ViewportSize;
-	if (GEngine && GEngine->GameViewport)
-	{
-		GEngine->GameViewport->GetViewportSize(ViewportSize);
-	}
-
-	// Get screen space of crosshairs
-	FVector2D CrosshairLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
-
-	FVector CrosshairWorldPosition;
-	FVector CrosshairWorldDirection;
-
-
-	// Get world position and direction of crosshairs
-	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0), CrosshairLocation,
-		CrosshairWorldPosition,
-		CrosshairWorldDirection);
-
-	if (bScreenToWorld) // was deprojection succesfull?
-	{
-		FHitResult ScreenTraceHit;
-		const FVector Start = CrosshairWorldPosition;
-		const FVector End = Start + CrosshairWorldDirection * 50'000.f;
-
-		// Set end location to line trace end point
-		EndLocation = End;
-
-		FCollisionQueryParams QueryParams;
-		QueryParams.AddIgnoredActor(this);
-		QueryParams.bTraceComplex = true;
-
-		// Trace outward from crosshairs world location
-		GetWorld()->LineTraceSingleByChannel(ScreenTraceHit, Start, End, ECollisionChannel::ECC_Visibility, QueryParams);
-
-		if (ScreenTraceHit.bBlockingHit) // did first trace hit?
-		{
-			//End location is now trace hit location
-			EndLocation = ScreenTraceHit.Location;
-
-			// This is for the testing, damage system is not complete
-			UGameplayStatics::ApplyDamage(ScreenTraceHit.GetActor(), 1.f, nullptr, nullptr, nullptr);
-
-			// Second trace from drone barrel
-			FHitResult WeaponTraceHit;
-			const FVector WeaponTraceStart = DroneSocketLocation;
-			const FVector WeaponTraceEnd = EndLocation;
-			GetWorld()->LineTraceSingleByChannel(WeaponTraceHit, WeaponTraceStart, WeaponTraceEnd, ECollisionChannel::ECC_Visibility, QueryParams);
-
-			if (WeaponTraceHit.bBlockingHit)
-			{
-				EndLocation = WeaponTraceHit.Location;
-
-			}
-			return true;
-		}
-	}
-	return false;
-
-}
-
-
-void ADrone::Turn(float Value)
-{
-	TurnValue = Value;
-}
-
-void ADrone::LookUp(float Value)
-{
-	LookUpValue = Value;
-}
-
-
-void ADrone::LookUpAtRate(float Rate)
-{
-	TurnValue = Rate;
-	//AddControllerPitchInput(Rate * BaseLookUpRate * GetWorld()->GetDeltaSeconds()); 
-
-}
-
-
-void ADrone::TurnAtRate(float Rate)
-{
-	LookUpValue = Rate;
-	//AddControllerYawInput(Rate * BaseTurnRate * GetWorld()->GetDeltaSeconds());
-}
-
-// Called every frame
-void ADrone::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-	UpdateSpringArm();
-	RotateCameraFocus();
-	UpdateCameraFOV();
-
-}
-
-// Called to bind functionality to input
-void ADrone::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
-{
-	Super::SetupPlayerInputComponent(PlayerInputComponent);
-
-	PlayerInputComponent->BindAxis("MoveForward", this, &ADrone::MoveForward);
-	PlayerInputComponent->BindAxis("MoveRight", this, &ADrone::MoveRight);
-	PlayerInputComponent->BindAxis("MoveUp", this, &ADrone::MoveUp);
-
-	PlayerInputComponent->BindAxis("TurnRate", this, &ADrone::TurnAtRate);
-	PlayerInputComponent->BindAxis("LookUpRate", this, &ADrone::LookUpAtRate);
-
-	PlayerInputComponent->BindAxis("Turn", this, &ADrone::Turn);
-	PlayerInputComponent->BindAxis("LookUp", this, &ADrone::LookUp);
-
-
-	PlayerInputComponent->BindAction("Dash", IE_Pressed, this, &ADrone::DroneDash);
-
-	PlayerInputComponent->BindAction("FireButton", IE_Pressed, this, &ADrone::Fire);
-
-}
+
+
+#include "Drone.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "Camera/CameraComponent.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "ShooterCharacter.h"
+#include "Engine/StaticMeshSocket.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundCue.h"
+#include "ShooterCameraRigComponent.h"
+#include "ShooterCooldownComponent.h"
+#include "DroneMovementComponent.h"
+#include "ShooterShotLatency.h"
+#include "ShooterProjesi.h"
+#include "ShooterTaskScheduler.h"
+#include "ShooterFixedStep.h"
+#include "ShooterHitchDetector.h"
+#include "ShooterAllocationTracker.h"
+#include "ShooterStreamingPrefetchComponent.h"
+#include "Components/InputComponent.h"
+#include "GameFramework/InputSettings.h"
+#include "GameFramework/PlayerController.h"
+
+static const FName BoostCooldownName(TEXT("Boost"));
+
+
+// Sets default values
+ADrone::ADrone()
+{
+ 	// Per frame camera work runs on the gameplay task scheduler
+	PrimaryActorTick.bCanEverTick = false;
+
+	DroneMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("DroneMesh"));
+	SetRootComponent(DroneMesh);
+	DroneMesh->SetSimulatePhysics(true);
+	DroneMesh->SetLinearDamping(1.f);
+	DroneMesh->SetAngularDamping(1.f);
+	DroneMesh->SetEnableGravity(false);
+
+	SpringArm = CreateDefaultSubobject<USpringArmComponent>(TEXT("SpringArm"));
+	SpringArm->SetupAttachment(DroneMesh);
+	SpringArm->SocketOffset= FVector(0.f, 0.f, 180.f);
+	SpringArm->SetUsingAbsoluteRotation(true);
+	SpringArm->TargetArmLength = 250.f;
+
+	Camera = CreateDefaultSubobject<UCameraComponent>(TEXT("Camera"));
+	Camera->SetupAttachment(SpringArm, USpringArmComponent::SocketName);
+
+	CameraRig = CreateDefaultSubobject<UShooterCameraRigComponent>(TEXT("CameraRig"));
+
+	Cooldowns = CreateDefaultSubobject<UShooterCooldownComponent>(TEXT("Cooldowns"));
+
+	StreamingPrefetch = CreateDefaultSubobject<UShooterStreamingPrefetchComponent>(TEXT("StreamingPrefetch"));
+
+	KinematicMovement = CreateDefaultSubobject<UDroneMovementComponent>(TEXT("KinematicMovement"));
+	KinematicMovement->SetUpdatedComponent(DroneMesh);
+	DroneMovementMode = EDroneMovementMode::EDMM_Physics;
+
+	MoveForwardValue=0.f;
+	MoveRightValue=0.f;
+	MoveUpValue=0.f;
+	TurnValue = 0.f;
+	LookUpValue = 0.f;
+
+	MovementSpeed = 600.f;
+	CameraSpeed = 7.f;
+	MaxRange = 5000.f;
+
+	BaseTurnRate = 45.f;
+	BaseLookUpRate = 45.f;
+
+	WeaponDamage = 1.f;
+
+	CameraFOVUpdateRate = 20.f;
+	CameraTaskId = INDEX_NONE;
+	CameraFOVTaskId = INDEX_NONE;
+	SimulationStepId = INDEX_NONE;
+	bParked = false;
+	PreviousStepRotation = FRotator::ZeroRotator;
+	StepRotation = FRotator::ZeroRotator;
+
+
+
+}
+
+// Called when the game starts or when spawned
+void ADrone::BeginPlay()
+{
+	Super::BeginPlay();
+
+	CameraRig->SetupRig(SpringArm, Camera);
+
+	PreviousStepRotation = GetActorRotation();
+	StepRotation = PreviousStepRotation;
+	if (UShooterFixedStepSubsystem* FixedStep = GetWorld()->GetSubsystem<UShooterFixedStepSubsystem>())
+	{
+		SimulationStepId = FixedStep->RegisterStep(FName("DroneSimulation"),
+			FShooterFixedStepDelegate::CreateUObject(this, &ADrone::SimulateStep), this);
+	}
+
+	if (UShooterTaskSchedulerSubsystem* Scheduler = GetWorld()->GetSubsystem<UShooterTaskSchedulerSubsystem>())
+	{
+		CameraTaskId = Scheduler->RegisterTask(FName("DroneCamera"), EShooterTaskPriority::High, 0.f,
+			FShooterScheduledTaskDelegate::CreateUObject(this, &ADrone::UpdateCamera), this);
+		CameraFOVTaskId = Scheduler->RegisterTask(FName("DroneCameraFOV"), EShooterTaskPriority::Normal, CameraFOVUpdateRate,
+			FShooterScheduledTaskDelegate::CreateUObject(this, &ADrone::UpdateCameraFOVTask), this);
+	}
+}
+
+void ADrone::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UShooterTaskSchedulerSubsystem* Scheduler = GetWorld()->GetSubsystem<UShooterTaskSchedulerSubsystem>())
+	{
+		Scheduler->UnregisterTask(CameraTaskId);
+		Scheduler->UnregisterTask(CameraFOVTaskId);
+	}
+	if (UShooterFixedStepSubsystem* FixedStep = GetWorld()->GetSubsystem<UShooterFixedStepSubsystem>())
+	{
+		FixedStep->UnregisterStep(SimulationStepId);
+	}
+	CameraTaskId = INDEX_NONE;
+	CameraFOVTaskId = INDEX_NONE;
+	SimulationStepId = INDEX_NONE;
+
+	EndExternalControl();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ADrone::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	ApplyMovementMode();
+}
+
+void ADrone::SetDroneMovementMode(EDroneMovementMode NewMode)
+{
+	if (DroneMovementMode == NewMode)
+	{
+		return;
+	}
+	const FVector CurrentVelocity = GetVelocity();
+	DroneMovementMode = NewMode;
+	if (IsActorInitialized())
+	{
+		ApplyMovementMode();
+		SetDroneVelocity(CurrentVelocity); // Keep flying the same way after switching
+	}
+}
+
+void ADrone::ApplyMovementMode()
+{
+	if (DroneMovementMode == EDroneMovementMode::EDMM_Kinematic)
+	{
+		DroneMesh->SetSimulatePhysics(false);
+		KinematicMovement->SetComponentTickEnabled(true);
+		KinematicMovement->Activate();
+	}
+	else
+	{
+		KinematicMovement->Deactivate();
+		KinematicMovement->SetComponentTickEnabled(false);
+		KinematicMovement->SetVelocity(FVector::ZeroVector);
+		DroneMesh->SetSimulatePhysics(true);
+	}
+}
+
+void ADrone::BeginExternalControl(APlayerController* PlayerController)
+{
+	if (PlayerController == nullptr || ExternalController.IsValid())
+	{
+		return;
+	}
+
+	if (InputComponent == nullptr)
+	{
+		InputComponent = NewObject<UInputComponent>(this, UInputSettings::GetDefaultInputComponentClass(), TEXT("DroneExternalInput"));
+		InputComponent->RegisterComponent();
+		SetupPlayerInputComponent(InputComponent);
+
+		// Components below on the stack, like the input recorder, still see the keys
+		for (int32 BindingIndex = 0; BindingIndex < InputComponent->GetNumActionBindings(); ++BindingIndex)
+		{
+			InputComponent->GetActionBinding(BindingIndex).bConsumeInput = false;
+		}
+		for (FInputAxisBinding& Binding : InputComponent->AxisBindings)
+		{
+			Binding.bConsumeInput = false;
+		}
+	}
+	// Above the possessed pawn's input on the controller's stack
+	PlayerController->PushInputComponent(InputComponent);
+	ExternalController = PlayerController;
+	UpdateStreamingPrefetch();
+}
+
+void ADrone::EndExternalControl()
+{
+	if (APlayerController* PlayerController = ExternalController.Get())
+	{
+		PlayerController->PopInputComponent(InputComponent);
+	}
+	ExternalController.Reset();
+
+	// Axis bindings stop being called, don't keep flying on the last values
+	MoveForwardValue = 0.f;
+	MoveRightValue = 0.f;
+	MoveUpValue = 0.f;
+	TurnValue = 0.f;
+	LookUpValue = 0.f;
+	UpdateStreamingPrefetch();
+}
+
+APlayerController* ADrone::GetExternalController() const
+{
+	return ExternalController.Get();
+}
+
+void ADrone::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	UpdateStreamingPrefetch();
+}
+
+void ADrone::UnPossessed()
+{
+	Super::UnPossessed();
+
+	UpdateStreamingPrefetch();
+}
+
+void ADrone::UpdateStreamingPrefetch()
+{
+	StreamingPrefetch->SetPrefetchActive(!bParked && (ExternalController.IsValid() || IsPlayerControlled()));
+}
+
+void ADrone::SetRangeAnchor(AActor* Anchor)
+{
+	RangeAnchor = Anchor;
+	// No point loading cells the drone can't reach
+	StreamingPrefetch->SetRangeLimit(Anchor, MaxRange);
+}
+
+FVector ADrone::ApplyRangeLimit(const FVector& Velocity) const
+{
+	const AActor* Anchor = RangeAnchor.Get();
+	if (Anchor == nullptr || MaxRange <= 0.f)
+	{
+		return Velocity;
+	}
+	const FVector FromAnchor = GetActorLocation() - Anchor->GetActorLocation();
+	if (FromAnchor.SizeSquared() <= FMath::Square(MaxRange))
+	{
+		return Velocity;
+	}
+	// Past the range only sideways and inward movement is left
+	const FVector Outward = FromAnchor.GetSafeNormal();
+	const float OutwardSpeed = FVector::DotProduct(Velocity, Outward);
+	return OutwardSpeed > 0.f ? Velocity - Outward * OutwardSpeed : Velocity;
+}
+
+void ADrone::SetParked(bool bNewParked)
+{
+	if (bParked == bNewParked)
+	{
+		return;
+	}
+	bParked = bNewParked;
+	SetActorHiddenInGame(bParked);
+	SetActorEnableCollision(!bParked);
+	if (bParked)
+	{
+		SetDroneVelocity(FVector::ZeroVector);
+		DroneMesh->SetSimulatePhysics(false);
+		KinematicMovement->SetComponentTickEnabled(false);
+	}
+	else
+	{
+		ApplyMovementMode();
+		// Don't blend from where the drone was parked
+		PreviousStepRotation = GetActorRotation();
+		StepRotation = PreviousStepRotation;
+	}
+	UpdateStreamingPrefetch();
+}
+
+void ADrone::SetDroneVelocity(const FVector& NewVelocity)
+{
+	if (DroneMovementMode == EDroneMovementMode::EDMM_Kinematic)
+	{
+		KinematicMovement->SetVelocity(NewVelocity);
+	}
+	else
+	{
+		DroneMesh->SetPhysicsLinearVelocity(NewVelocity);
+	}
+}
+
+
+void ADrone::MoveForward(float Value)
+{
+	MoveForwardValue = Value;
+}
+
+void ADrone::MoveRight(float Value)
+{
+	MoveRightValue = Value;
+}
+
+void ADrone::MoveUp(float Value)
+{
+	MoveUpValue = Value;
+}
+
+// Update actor's velocity based on MoveForwardValue, MoveRightValue, MoveUpValue
+void ADrone::DroneMovement(float StepTime)
+{
+	FVector MadeVector = UKismetMathLibrary::MakeVector(MoveForwardValue, MoveRightValue, MoveUpValue);
+	FRotator MadeRotator = FRotator(0.f, Camera->GetComponentRotation().Yaw, 0.f);
+
+	MadeVector = MadeRotator.RotateVector(MadeVector);
+
+	MadeVector = MadeVector * MovementSpeed * StepTime;
+
+	MadeVector = MadeVector + GetVelocity();
+
+	SetDroneVelocity(ApplyRangeLimit(MadeVector));
+}
+
+// Rotate spring arm component
+void ADrone::UpdateSpringArm()
+{
+	if (TurnValue == 0.f && LookUpValue == 0.f)
+	{
+		return; // Rig keeps interpolating to the last target
+	}
+
+	FRotator SpringRotation = SpringArm->GetComponentRotation();
+	float SpringArmYaw = SpringRotation.Yaw;
+	float SpringArmPitch = SpringRotation.Pitch;
+
+	float RotatorPitch = (CameraSpeed * (-1.f) * LookUpValue) + SpringArmPitch;
+	RotatorPitch =	UKismetMathLibrary::ClampAngle(RotatorPitch,-45.f, 85.f);
+	
+
+	float RotatorYaw = (TurnValue * CameraSpeed) + SpringArmYaw;
+
+	FRotator SpringArmTargetRotation  = UKismetMathLibrary::MakeRotator(0.f, RotatorPitch, RotatorYaw);
+	
+
+	CameraRig->SetTargetArmRotation(SpringArmTargetRotation, 8.f);
+}
+
+// Rotate drone to face away from the camera, the actor follows in UpdateCamera
+void ADrone::RotateCameraFocus(float StepTime)
+{
+	FRotator LookAtRotation = UKismetMathLibrary::FindLookAtRotation(Camera->GetComponentLocation(), GetActorLocation());
+	FRotator ActorNewRotation = UKismetMathLibrary::MakeRotator((MoveRightValue * (20.f)), (MoveForwardValue * (-7.f)), LookAtRotation.Yaw);
+
+	PreviousStepRotation = StepRotation;
+	StepRotation = UKismetMathLibrary::RInterpTo(StepRotation, ActorNewRotation, StepTime, 4.f);
+}
+
+void ADrone::SimulateStep(float StepTime)
+{
+	if (bParked)
+	{
+		return;
+	}
+	DroneMovement(StepTime);
+	UpdateSpringArm();
+	RotateCameraFocus(StepTime);
+}
+
+// Update camera fiel of view based on drone's velocity
+void ADrone::UpdateCameraFOV()
+{
+	float VelocityLen = GetVelocity().Length();
+
+	VelocityLen = UKismetMathLibrary::MapRangeUnclamped(VelocityLen, 300.f, 1'000.f, 75.f, 110.f);
+	VelocityLen = UKismetMathLibrary::Clamp(VelocityLen, 75.f, 110.f);
+
+	CameraRig->SetTargetFOV(VelocityLen, 8.f);
+}
+
+// Small dash based on drone's velocity 
+void ADrone::DroneDash()
+{
+	if (!Cooldowns->IsOnCooldown(BoostCooldownName))
+	{
+		Cooldowns->StartCooldown(BoostCooldownName, 5.f);
+		
+		FVector BoostVector = GetVelocity() * 2.f;
+		SetDroneVelocity(BoostVector);
+	
+	}
+
+
+
+}
+
+// Keep boost cooldown in step with this drone's time
+void ADrone::OnCustomTimeDilationChanged(float OldDilation, float NewDilation)
+{
+	Cooldowns->RescaleCooldowns(OldDilation / FMath::Max(NewDilation, KINDA_SMALL_NUMBER));
+}
+
+void ADrone::Fire()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(ADrone::Fire);
+	SHOOTER_HITCH_SCOPE("DroneFire");
+	SHOOTER_ALLOCATION_SCOPE("DroneFire");
+	FShooterShotLatencyTracker& LatencyTracker = FShooterShotLatencyTracker::Get();
+	LatencyTracker.MarkInput(); // Fire is bound directly to the input
+	const uint32 ShotId = LatencyTracker.BeginShot();
+
+	if (FireSound)
+	{
+		UGameplayStatics::PlaySound2D(this, FireSound);
+	}
+
+	const FTransform SocketTransform = DroneMesh->GetSocketTransform("DroneBarrel");
+
+	FVector BeamEnd;
+	FHitResult ImpactHit;
+	bool bBeamEnd = GetBeamEndLocation(SocketTransform.GetLocation(), BeamEnd, ImpactHit);
+	LatencyTracker.MarkStage(ShotId, EShotLatencyStage::TraceResolved);
+
+	if (bBeamEnd)
+	{
+		// Spawn impact particles after updating BeamEndPoint
+		AShooterCharacter::PlayWeaponImpact(GetWorld(), ImpactHit, ImpactResponses, ImpactParticle);
+
+
+	}
+	LatencyTracker.SubmitShot(ShotId);
+}
+
+bool ADrone::GetBeamEndLocation(const FVector & DroneSocketLocation, FVector & EndLocation, FHitResult& OutImpactHit)
+{
+
+
+	// Get Viewport Size
+	FVector2D ViewportSize;
+	if (GEngine && GEngine->GameViewport)
+	{
+		GEngine->GameViewport->GetViewportSize(ViewportSize);
+	}
+
+	// Get screen space of crosshairs
+	FVector2D CrosshairLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
+
+	FVector CrosshairWorldPosition;
+	FVector CrosshairWorldDirection;
+
+
+	// Get world position and direction of crosshairs
+	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0), CrosshairLocation,
+		CrosshairWorldPosition,
+		CrosshairWorldDirection);
+
+	if (bScreenToWorld) // was deprojection succesfull?
+	{
+		FHitResult ScreenTraceHit;
+		const FVector Start = CrosshairWorldPosition;
+		const FVector End = Start + CrosshairWorldDirection * 50'000.f;
+
+		// Set end location to line trace end point
+		EndLocation = End;
+
+		// Simple collision only, characters are hit on their physics asset bodies. Physical material picks the impact response
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterWeaponTrace), false, this);
+		QueryParams.bReturnPhysicalMaterial = true;
+
+		// Trace outward from crosshairs world location
+		GetWorld()->LineTraceSingleByChannel(ScreenTraceHit, Start, End, COLLISION_WEAPON, QueryParams);
+
+		if (ScreenTraceHit.bBlockingHit) // did first trace hit?
+		{
+			//End location is now trace hit location
+			EndLocation = ScreenTraceHit.Location;
+			OutImpactHit = ScreenTraceHit;
+
+			AShooterCharacter::ApplyWeaponDamage(ScreenTraceHit, WeaponDamage, CrosshairWorldDirection, this, ImpactResponses);
+
+			// Second trace from drone barrel
+			FHitResult WeaponTraceHit;
+			const FVector WeaponTraceStart = DroneSocketLocation;
+			const FVector WeaponTraceEnd = EndLocation;
+			GetWorld()->LineTraceSingleByChannel(WeaponTraceHit, WeaponTraceStart, WeaponTraceEnd, COLLISION_WEAPON, QueryParams);
+
+			if (WeaponTraceHit.bBlockingHit)
+			{
+				EndLocation = WeaponTraceHit.Location;
+				OutImpactHit = WeaponTraceHit;
+
+			}
+			return true;
+		}
+	}
+	return false;
+
+}
+
+
+void ADrone::Turn(float Value)
+{
+	TurnValue = Value;
+}
+
+void ADrone::LookUp(float Value)
+{
+	LookUpValue = Value;
+}
+
+
+void ADrone::LookUpAtRate(float Rate)
+{
+	TurnValue = Rate;
+	//AddControllerPitchInput(Rate * BaseLookUpRate * GetWorld()->GetDeltaSeconds()); 
+
+}
+
+
+void ADrone::TurnAtRate(float Rate)
+{
+	LookUpValue = Rate;
+	//AddControllerYawInput(Rate * BaseTurnRate * GetWorld()->GetDeltaSeconds());
+}
+
+void ADrone::UpdateCamera(float DeltaTime)
+{
+	if (bParked)
+	{
+		return;
+	}
+	CameraRig->SetCameraFocusOnOwner(2.f);
+
+	// Blend between the last two simulated rotations so the drone turns smoothly above the step rate
+	const UShooterFixedStepSubsystem* FixedStep = GetWorld()->GetSubsystem<UShooterFixedStepSubsystem>();
+	const float Alpha = FixedStep ? FixedStep->GetInterpolationAlpha() : 1.f;
+	const FRotator ActorNewRotation = FQuat::Slerp(PreviousStepRotation.Quaternion(), StepRotation.Quaternion(), Alpha).Rotator();
+
+	if (!ActorNewRotation.Equals(GetActorRotation(), 0.01f))
+	{
+		SetActorRotation(ActorNewRotation);
+	}
+}
+
+void ADrone::UpdateCameraFOVTask(float DeltaTime)
+{
+	UpdateCameraFOV();
+}
+
+// Called to bind functionality to input
+void ADrone::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
+{
+	Super::SetupPlayerInputComponent(PlayerInputComponent);
+
+	PlayerInputComponent->BindAxis("MoveForward", this, &ADrone::MoveForward);
+	PlayerInputComponent->BindAxis("MoveRight", this, &ADrone::MoveRight);
+	PlayerInputComponent->BindAxis("MoveUp", this, &ADrone::MoveUp);
+
+	PlayerInputComponent->BindAxis("TurnRate", this, &ADrone::TurnAtRate);
+	PlayerInputComponent->BindAxis("LookUpRate", this, &ADrone::LookUpAtRate);
+
+	PlayerInputComponent->BindAxis("Turn", this, &ADrone::Turn);
+	PlayerInputComponent->BindAxis("LookUp", this, &ADrone::LookUp);
+
+
+	PlayerInputComponent->BindAction("Dash", IE_Pressed, this, &ADrone::DroneDash);
+
+	PlayerInputComponent->BindAction("FireButton", IE_Pressed, this, &ADrone::Fire);
+
+}
@@ -1,117 +1,216 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Pawn.h"
-#include "Drone.generated.h"
-
-UCLASS()
-class SHOOTERPROJESI_API ADrone : public APawn
-{
-	GENERATED_BODY()
-
-public:
-	// Sets default values for this pawn's properties
-	ADrone();
-
-protected:
-	// Called when the game starts or when spawned
-	virtual void BeginPlay() override;
-
-	void MoveForward(float Value); // Set MoveForwardValue to the Value and calls DroneMovement() function
-
-	void MoveRight(float Value); //  Set MoveRightValue to the Value and calls DroneMovement() function
-
-	void MoveUp(float Value); //  Set MoveUpValue to the Value and calls DroneMovement() function
-
-	void DroneMovement(); // Update actor's velocity based on MoveForwardValue, MoveRightValue, MoveUpValue
-
-	void UpdateSpringArm(); // Rotate spring arm component
-
-	void RotateCameraFocus(); // Rotate camera to drone
-
-	void UpdateCameraFOV(); // Update camera fiel of view based on drone's velocity
-
-	void DroneDash(); // Small dash based on drone's velocity 
-
-	void SetBoostState(); //  Set bIsBoostReady for cooldown
-
-	void Fire(); 
-
-	bool GetBeamEndLocation(const FVector& DroneSocketLocation, FVector& EndLocation);
-
-
-	void Turn(float Value);
-
-	void LookUp(float Value);
-
-	// These can be used with arrow keys but are specifically for Gamepad sticks.
-	void LookUpAtRate(float Rate);
-	void TurnAtRate(float Rate);
-
-
-
-
-
-public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
-	// Called to bind functionality to input
-	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
-
-	
-private:
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh", meta = (AllowPrivateAccess = "true"))
-	class UStaticMeshComponent* DroneMesh;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera", meta = (AllowPrivateAccess = "true"))
-	class USpringArmComponent* SpringArm;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera", meta = (AllowPrivateAccess = "true"))
-	class UCameraComponent* Camera;
-
-	
-
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
-	float MoveForwardValue; 
-
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
-	float MoveRightValue;
-
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
-	float MoveUpValue;
-
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
-	float TurnValue;
-
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
-	float LookUpValue;
-
-	UPROPERTY(VisibleAnywhere, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
-	float BaseTurnRate;
-
-	UPROPERTY(VisibleAnywhere, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
-	float BaseLookUpRate;
-
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
-	float MovementSpeed; // Movement speed for drone
-
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
-	float CameraSpeed; // Camera speed for drone
-
-	bool bIsBoostReady;
-	
-	FTimerHandle BoostTimer;
-
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
-	class UParticleSystem* ImpactParticle;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
-	class USoundCue* FireSound;
-
-
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Pawn.h"
+#include "ShooterTimeDilationSubsystem.h"
+#include "Drone.generated.h"
+
+UENUM(BlueprintType)
+enum class EDroneMovementMode : uint8
+{
+	// Simulated rigid body with damping and no gravity
+	EDMM_Physics UMETA(DisplayName = "Physics"),
+	// UDroneMovementComponent integrates velocity and sweeps, no simulated body
+	EDMM_Kinematic UMETA(DisplayName = "Kinematic")
+};
+
+UCLASS()
+class SHOOTERPROJESI_API ADrone : public APawn, public IShooterTimeDilationListener
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this pawn's properties
+	ADrone();
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void PostInitializeComponents() override;
+
+	void ApplyMovementMode(); // Enable physics simulation or the kinematic movement component
+
+	void MoveForward(float Value); // Set MoveForwardValue to the Value and calls DroneMovement() function
+
+	void MoveRight(float Value); //  Set MoveRightValue to the Value and calls DroneMovement() function
+
+	void MoveUp(float Value); //  Set MoveUpValue to the Value and calls DroneMovement() function
+
+	void DroneMovement(float StepTime); // Update actor's velocity based on MoveForwardValue, MoveRightValue, MoveUpValue
+
+	void UpdateSpringArm(); // Set spring arm target rotation
+
+	void RotateCameraFocus(float StepTime); // Rotate camera and drone to face each other
+
+	void SimulateStep(float StepTime); // Fixed step movement, spring arm target and drone rotation
+
+	void UpdateCameraFOV(); // Set camera field of view target based on drone's velocity
+
+	void UpdateCamera(float DeltaTime); // Scheduled every frame, camera focus and drone rotation between fixed steps
+
+	void UpdateCameraFOVTask(float DeltaTime); // Scheduled at CameraFOVUpdateRate
+
+	void UpdateStreamingPrefetch(); // Stream ahead of the drone only while a player flies it
+
+	FVector ApplyRangeLimit(const FVector& Velocity) const; // Remove the velocity taking the drone further past MaxRange
+
+	void DroneDash(); // Small dash based on drone's velocity 
+
+	void Fire(); 
+
+	bool GetBeamEndLocation(const FVector& DroneSocketLocation, FVector& EndLocation, FHitResult& OutImpactHit);
+
+
+	void Turn(float Value);
+
+	void LookUp(float Value);
+
+	// These can be used with arrow keys but are specifically for Gamepad sticks.
+	void LookUpAtRate(float Rate);
+	void TurnAtRate(float Rate);
+
+
+
+
+
+public:	
+	// Called to bind functionality to input
+	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
+
+	virtual void PossessedBy(AController* NewController) override;
+
+	virtual void UnPossessed() override;
+
+	// Switch between physics and kinematic flight, can be called before FinishSpawning
+	void SetDroneMovementMode(EDroneMovementMode NewMode);
+
+	// Set velocity on the rigid body or the movement component depending on movement mode
+	void SetDroneVelocity(const FVector& NewVelocity);
+
+	FORCEINLINE EDroneMovementMode GetDroneMovementMode() const { return DroneMovementMode; }
+
+	// Drives the drone from PlayerController's input without possessing it. The input component is bound once and kept
+	void BeginExternalControl(APlayerController* PlayerController);
+
+	void EndExternalControl();
+
+	APlayerController* GetExternalController() const;
+
+	// A parked drone is hidden, doesn't collide and skips its simulation until it is reused
+	void SetParked(bool bNewParked);
+
+	FORCEINLINE bool IsParked() const { return bParked; }
+
+	// The drone can't fly further than MaxRange from Anchor, usually the character that launched it. Null for no limit
+	void SetRangeAnchor(AActor* Anchor);
+
+	virtual void OnCustomTimeDilationChanged(float OldDilation, float NewDilation) override;
+	
+private:
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Mesh", meta = (AllowPrivateAccess = "true"))
+	class UStaticMeshComponent* DroneMesh;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera", meta = (AllowPrivateAccess = "true"))
+	class USpringArmComponent* SpringArm;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera", meta = (AllowPrivateAccess = "true"))
+	class UCameraComponent* Camera;
+
+	// Used instead of physics simulation when DroneMovementMode is kinematic
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	class UDroneMovementComponent* KinematicMovement;
+
+	// Physics is smoother with other simulated bodies, kinematic is much cheaper for many AI drones
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	EDroneMovementMode DroneMovementMode;
+
+	// Interpolates spring arm rotation, camera focus and FOV, sleeps when converged
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Camera", meta = (AllowPrivateAccess = "true"))
+	class UShooterCameraRigComponent* CameraRig;
+
+	// Boost cooldown
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	class UShooterCooldownComponent* Cooldowns;
+
+	// Loads world partition cells ahead of the drone while a player flies it
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Streaming", meta = (AllowPrivateAccess = "true"))
+	class UShooterStreamingPrefetchComponent* StreamingPrefetch;
+
+	
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	float MoveForwardValue; 
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	float MoveRightValue;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	float MoveUpValue;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	float TurnValue;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	float LookUpValue;
+
+	UPROPERTY(VisibleAnywhere, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
+	float BaseTurnRate;
+
+	UPROPERTY(VisibleAnywhere, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
+	float BaseLookUpRate;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	float MovementSpeed; // Movement speed for drone
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	float CameraSpeed; // Camera speed for drone
+
+	// Distance from the range anchor the drone can fly, 0 for no limit
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	float MaxRange;
+
+	TWeakObjectPtr<AActor> RangeAnchor;
+
+
+
+	// Used when there is no ImpactResponses table
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	class UParticleSystem* ImpactParticle;
+
+	// Impact effects, decals and damage multipliers per physical surface
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	class UShooterImpactResponseTable* ImpactResponses;
+
+	// Damage of a single shot before hitbox multipliers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	float WeaponDamage;
+
+	// Times per second the FOV target follows the velocity, the rig interpolates in between
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera", meta = (AllowPrivateAccess = "true"))
+	float CameraFOVUpdateRate;
+
+	// Scheduled task ids, registered in BeginPlay
+	int32 CameraTaskId;
+	int32 CameraFOVTaskId;
+	int32 SimulationStepId;
+
+	// Controller driving the drone through BeginExternalControl
+	TWeakObjectPtr<APlayerController> ExternalController;
+
+	bool bParked;
+
+	// Drone rotation after the previous and the last fixed step, the actor is drawn between them
+	FRotator PreviousStepRotation;
+	FRotator StepRotation;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	class USoundCue* FireSound;
+
+
+};
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DroneMovementComponent.h"
+
+UDroneMovementComponent::UDroneMovementComponent()
+{
+	LinearDamping = 1.f;
+	MaxSpeed = 3'000.f;
+	SurfaceFriction = 0.8f;
+}
+
+void UDroneMovementComponent::SetVelocity(const FVector& NewVelocity)
+{
+	Velocity = NewVelocity;
+}
+
+void UDroneMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (ShouldSkipUpdate(DeltaTime) || !UpdatedComponent)
+	{
+		return;
+	}
+
+	// Same damping model as the physics engine: v *= 1 / (1 + damping * dt)
+	Velocity *= 1.f / (1.f + LinearDamping * DeltaTime);
+	Velocity = Velocity.GetClampedToMaxSize(MaxSpeed);
+
+	if (Velocity.IsNearlyZero(1.f))
+	{
+		Velocity = FVector::ZeroVector;
+		return; // Hovering, nothing to sweep
+	}
+
+	const FVector Delta = Velocity * DeltaTime;
+	FHitResult Hit;
+	SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit);
+
+	if (Hit.IsValidBlockingHit())
+	{
+		// Slide along whatever we hit and lose the velocity going into it
+		SlideAlongSurface(Delta, 1.f - Hit.Time, Hit.Normal, Hit, true);
+		Velocity = FVector::VectorPlaneProject(Velocity, Hit.Normal) * SurfaceFriction;
+	}
+
+	UpdateComponentVelocity();
+}
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PawnMovementComponent.h"
+#include "DroneMovementComponent.generated.h"
+
+/*
+	Kinematic flight for ADrone. Integrates velocity and linear damping itself and resolves collisions with
+	sweeps, so the drone doesn't need a simulated rigid body in the physics scene.
+*/
+UCLASS(ClassGroup = (Movement), meta = (BlueprintSpawnableComponent))
+class SHOOTERPROJESI_API UDroneMovementComponent : public UPawnMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDroneMovementComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	virtual float GetMaxSpeed() const override { return MaxSpeed; }
+
+	// Replaces current velocity, same as SetPhysicsLinearVelocity
+	void SetVelocity(const FVector& NewVelocity);
+
+private:
+	// Same meaning as the rigid body linear damping used in physics mode
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Drone Movement", meta = (AllowPrivateAccess = "true"))
+	float LinearDamping;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Drone Movement", meta = (AllowPrivateAccess = "true"))
+	float MaxSpeed;
+
+	// Fraction of velocity kept along the surface after hitting something
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Drone Movement", meta = (AllowPrivateAccess = "true"), meta = (ClampMin = "0.0", ClampMax = 1.0, UIMin = "0.0", UIMax = "1.0"))
+	float SurfaceFriction;
+};
@@ -0,0 +1,228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DroneSwarm.h"
+#include "Drone.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+
+int32 FDroneSwarmSimulation::AddUnit(const FVector& Position, const FVector& Target)
+{
+	Positions.Add(Position);
+	Velocities.Add(FVector::ZeroVector);
+	Targets.Add(Target);
+	return WeaponCooldowns.Add(FireInterval);
+}
+
+void FDroneSwarmSimulation::RemoveUnitAtSwap(int32 Index)
+{
+	Positions.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	Targets.RemoveAtSwap(Index, 1, false);
+	WeaponCooldowns.RemoveAtSwap(Index, 1, false);
+}
+
+void FDroneSwarmSimulation::Step(float DeltaTime)
+{
+	const int32 NumUnits = Num();
+	const int32 NumChunks = FMath::DivideAndRoundUp(NumUnits, FMath::Max(ChunkSize, 1));
+	TArray<int32, TInlineAllocator<64>> ChunkShots;
+	ChunkShots.SetNumZeroed(NumChunks);
+
+	ParallelFor(NumChunks, [this, DeltaTime, NumUnits, &ChunkShots](int32 ChunkIndex)
+	{
+		const int32 First = ChunkIndex * ChunkSize;
+		const int32 Last = FMath::Min(First + ChunkSize, NumUnits);
+		const float ArriveRadiusSquared = ArriveRadius * ArriveRadius;
+		const float FireRangeSquared = FireRange * FireRange;
+		int32 Shots = 0;
+
+		for (int32 Unit = First; Unit < Last; ++Unit)
+		{
+			FVector& Position = Positions[Unit];
+			FVector& Velocity = Velocities[Unit];
+			FVector& Target = Targets[Unit];
+
+			// Steer towards target, mirror it through the center once reached so units keep patrolling
+			FVector ToTarget = Target - Position;
+			if (ToTarget.SizeSquared() < ArriveRadiusSquared)
+			{
+				Target = Center * 2.f - Target;
+				ToTarget = Target - Position;
+			}
+			const FVector DesiredVelocity = ToTarget.GetSafeNormal() * MaxSpeed;
+			Velocity += (DesiredVelocity - Velocity).GetClampedToMaxSize(Acceleration * DeltaTime);
+			Position += Velocity * DeltaTime;
+
+			// Fire at a hostile when one is in range and the weapon is ready, hostiles are a handful of players
+			float& Cooldown = WeaponCooldowns[Unit];
+			Cooldown -= DeltaTime;
+			if (Cooldown <= 0.f && HostileLocations.ContainsByPredicate([&Position, FireRangeSquared](const FVector& Hostile) { return FVector::DistSquared(Position, Hostile) < FireRangeSquared; }))
+			{
+				Cooldown += FireInterval;
+				++Shots;
+			}
+			Cooldown = FMath::Max(Cooldown, 0.f);
+		}
+		ChunkShots[ChunkIndex] = Shots;
+	});
+
+	ShotsFiredLastStep = 0;
+	for (int32 Shots : ChunkShots)
+	{
+		ShotsFiredLastStep += Shots;
+	}
+}
+
+int32 FDroneSwarmSimulation::FindClosestUnit(const FVector& Location) const
+{
+	int32 ClosestUnit = INDEX_NONE;
+	float ClosestDistanceSquared = TNumericLimits<float>::Max();
+	for (int32 Unit = 0; Unit < Num(); ++Unit)
+	{
+		const float DistanceSquared = FVector::DistSquared(Positions[Unit], Location);
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestDistanceSquared = DistanceSquared;
+			ClosestUnit = Unit;
+		}
+	}
+	return ClosestUnit;
+}
+
+// Sets default values
+ADroneSwarm::ADroneSwarm()
+{
+	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+	PrimaryActorTick.bCanEverTick = true;
+
+	UnitMeshes = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("UnitMeshes"));
+	SetRootComponent(UnitMeshes);
+	UnitMeshes->SetCollisionEnabled(ECollisionEnabled::NoCollision); // Units are data, only promoted drones collide
+	UnitMeshes->SetMobility(EComponentMobility::Movable);
+
+	InitialUnitCount = 200;
+	PatrolRadius = 5'000.f;
+	UnitMaxSpeed = 800.f;
+}
+
+// Called when the game starts or when spawned
+void ADroneSwarm::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Simulation.Center = GetActorLocation();
+	Simulation.MaxSpeed = UnitMaxSpeed;
+
+	PatrolRandom.Initialize(GetUniqueID());
+	for (int32 Unit = 0; Unit < InitialUnitCount; ++Unit)
+	{
+		const FVector Position = GetRandomPatrolPoint();
+		Simulation.AddUnit(Position, GetRandomPatrolPoint());
+	}
+	UpdateInstances();
+}
+
+// Called every frame
+void ADroneSwarm::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UpdateHostileLocations();
+	Simulation.Step(DeltaTime);
+	UpdateInstances();
+}
+
+void ADroneSwarm::UpdateHostileLocations()
+{
+	Simulation.HostileLocations.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr;
+		if (Pawn)
+		{
+			Simulation.HostileLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+}
+
+FVector ADroneSwarm::GetRandomPatrolPoint()
+{
+	return Simulation.Center + PatrolRandom.VRand() * PatrolRandom.FRandRange(0.f, PatrolRadius);
+}
+
+void ADroneSwarm::UpdateInstances()
+{
+	const int32 NumUnits = Simulation.Num();
+	InstanceTransforms.SetNum(NumUnits, false);
+
+	ParallelFor(NumUnits, [this](int32 Unit)
+	{
+		const FVector& Velocity = Simulation.Velocities[Unit];
+		const FRotator Facing = Velocity.IsNearlyZero() ? FRotator::ZeroRotator : FRotator(0.f, Velocity.Rotation().Yaw, 0.f);
+		InstanceTransforms[Unit] = FTransform(Facing, Simulation.Positions[Unit]);
+	});
+
+	// Keep instance count in sync with the simulation, removed units are swapped so only the tail changes
+	while (UnitMeshes->GetInstanceCount() > NumUnits)
+	{
+		UnitMeshes->RemoveInstance(UnitMeshes->GetInstanceCount() - 1);
+	}
+	while (UnitMeshes->GetInstanceCount() < NumUnits)
+	{
+		UnitMeshes->AddInstance(FTransform::Identity, true);
+	}
+	if (NumUnits > 0)
+	{
+		UnitMeshes->BatchUpdateInstancesTransforms(0, InstanceTransforms, true, true, true);
+	}
+}
+
+ADrone* ADroneSwarm::PromoteClosestUnit(const FVector& Location, APlayerController* PlayerController)
+{
+	return PromoteUnit(Simulation.FindClosestUnit(Location), PlayerController);
+}
+
+ADrone* ADroneSwarm::PromoteUnit(int32 UnitIndex, APlayerController* PlayerController)
+{
+	if (!Simulation.Positions.IsValidIndex(UnitIndex) || DroneClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	const FVector Velocity = Simulation.Velocities[UnitIndex];
+	const FTransform UnitTransform(FRotator(0.f, Velocity.Rotation().Yaw, 0.f), Simulation.Positions[UnitIndex]);
+
+	ADrone* Drone = GetWorld()->SpawnActorDeferred<ADrone>(DroneClass, UnitTransform, this, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+	if (Drone == nullptr)
+	{
+		return nullptr;
+	}
+	Drone->FinishSpawning(UnitTransform);
+	Drone->SetDroneVelocity(Velocity);
+
+	// The actor replaces the unit from now on
+	Simulation.RemoveUnitAtSwap(UnitIndex);
+	UpdateInstances();
+
+	if (PlayerController)
+	{
+		PlayerController->Possess(Drone);
+	}
+	return Drone;
+}
+
+void ADroneSwarm::ReturnDroneToSwarm(ADrone* Drone)
+{
+	if (Drone == nullptr)
+	{
+		return;
+	}
+	// The center mirrors onto itself on arrival, a returned unit needs a real patrol point to keep patrolling
+	const int32 Unit = Simulation.AddUnit(Drone->GetActorLocation(), GetRandomPatrolPoint());
+	Simulation.Velocities[Unit] = Drone->GetVelocity();
+	Drone->Destroy();
+	UpdateInstances();
+}
@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "DroneSwarm.generated.h"
+
+class ADrone;
+class APlayerController;
+
+/*
+	Data only simulation of autonomous drones. Each fragment is a separate array indexed by unit,
+	units are processed in parallel chunks and nothing here touches UObjects so it can run headless.
+*/
+struct SHOOTERPROJESI_API FDroneSwarmSimulation
+{
+	// Fragments
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<FVector> Targets;
+	TArray<float> WeaponCooldowns;
+
+	// Center the units patrol around, targets are mirrored through it on arrival
+	FVector Center = FVector::ZeroVector;
+
+	// What units shoot at, e.g. player pawns. Set before Step, units only fire with one within FireRange
+	TArray<FVector> HostileLocations;
+
+	float MaxSpeed = 800.f;
+	float Acceleration = 1'500.f;
+	float ArriveRadius = 150.f;
+	float FireInterval = 0.5f;
+	float FireRange = 2'000.f;
+
+	// Units processed by a single worker task
+	int32 ChunkSize = 256;
+
+	// Shots fired at hostiles by all units during the last Step
+	int32 ShotsFiredLastStep = 0;
+
+	int32 Num() const { return Positions.Num(); }
+
+	int32 AddUnit(const FVector& Position, const FVector& Target);
+
+	// Swaps the last unit into Index, callers mirroring unit indices must do the same
+	void RemoveUnitAtSwap(int32 Index);
+
+	void Step(float DeltaTime);
+
+	int32 FindClosestUnit(const FVector& Location) const;
+};
+
+/*
+	Renders a FDroneSwarmSimulation with one instanced static mesh. A unit becomes a real ADrone actor
+	only when a player takes control of it.
+*/
+UCLASS()
+class SHOOTERPROJESI_API ADroneSwarm : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this actor's properties
+	ADroneSwarm();
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+public:
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+	// Spawns a drone in place of the unit closest to Location and gives it to PlayerController, nullptr if the swarm is empty
+	ADrone* PromoteClosestUnit(const FVector& Location, APlayerController* PlayerController);
+
+	// Spawns a drone in place of UnitIndex and gives it to PlayerController
+	ADrone* PromoteUnit(int32 UnitIndex, APlayerController* PlayerController);
+
+	// Turns a promoted drone back into a swarm unit and destroys the actor
+	void ReturnDroneToSwarm(ADrone* Drone);
+
+	FORCEINLINE const FDroneSwarmSimulation& GetSimulation() const { return Simulation; }
+
+private:
+	// Writes every unit transform to the instanced mesh
+	void UpdateInstances();
+
+	// Player pawn locations as the simulation's hostiles
+	void UpdateHostileLocations();
+
+	// Random point inside PatrolRadius around the center
+	FVector GetRandomPatrolPoint();
+
+	FDroneSwarmSimulation Simulation;
+
+	// Seeded per swarm at BeginPlay, patrol points are reproducible between runs
+	FRandomStream PatrolRandom;
+
+	// Reused between frames to avoid reallocating
+	TArray<FTransform> InstanceTransforms;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Swarm", meta = (AllowPrivateAccess = "true"))
+	class UInstancedStaticMeshComponent* UnitMeshes;
+
+	// Drone class spawned when a unit is promoted
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Swarm", meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<ADrone> DroneClass;
+
+	// Units spawned at BeginPlay
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Swarm", meta = (AllowPrivateAccess = "true"))
+	int32 InitialUnitCount;
+
+	// Units spawn and patrol inside this radius around the actor
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Swarm", meta = (AllowPrivateAccess = "true"))
+	float PatrolRadius;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Swarm", meta = (AllowPrivateAccess = "true"))
+	float UnitMaxSpeed;
+};
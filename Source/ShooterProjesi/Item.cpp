@@ -1,41 +1,162 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "Item.h"
-#include "Components/BoxComponent.h"
-#include "Components/WidgetComponent.h"
-
-// Sets default values
-AItem::AItem()
-{
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
-
-	ItemMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("ItemMesh"));
-	SetRootComponent(ItemMesh);
-
-	CollisionBox = CreateDefaultSubobject<UBoxComponent>(TEXT("CollisionBox"));
-	CollisionBox->SetupAttachment(ItemMesh);
-
-	PickupWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("PickupWidget"));
-	PickupWidget->SetupAttachment(GetRootComponent());
-
-}
-
-// Called when the game starts or when spawned
-void AItem::BeginPlay()
-{
-	Super::BeginPlay();
-
-	// Hide Pickup Widget
-	PickupWidget->SetVisibility(false);
-	
-}
-
-// Called every frame
-void AItem::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-}
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Item.h"
+#include "Components/BoxComponent.h"
+#include "ShooterItemRenderSubsystem.h"
+#include "ShooterProjesi.h"
+#include "Net/UnrealNetwork.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Relevancy Checks"), STAT_ShooterItemRelevancyChecks, STATGROUP_Shooter);
+
+// Sets default values
+AItem::AItem()
+{
+ 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+	PrimaryActorTick.bCanEverTick = true;
+
+	ItemMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("ItemMesh"));
+	SetRootComponent(ItemMesh);
+
+	CollisionBox = CreateDefaultSubobject<UBoxComponent>(TEXT("CollisionBox"));
+	CollisionBox->SetupAttachment(ItemMesh);
+	// Found by the character's item focus query
+	CollisionBox->SetCollisionObjectType(ECC_WorldDynamic);
+	CollisionBox->SetCollisionResponseToAllChannels(ECR_Ignore);
+	CollisionBox->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
+
+	// Pickup widgets are pooled by the HUD, see AShooterHUD::SetFocusedItems
+	PickupWidgetOffset = FVector(0.f, 0.f, 50.f);
+
+	DroppedMesh = nullptr;
+	ItemState = EItemState::EIS_Dropped;
+	bDrawnAsInstance = false;
+
+	// Replicates once, then only when SetItemState flushes dormancy. Movement carries the attachment to characters
+	bReplicates = true;
+	SetReplicatingMovement(true);
+	NetDormancy = DORM_Initial;
+	NetUpdateFrequency = 1.f;
+	NetCullDistanceSquared = FMath::Square(5000.f);
+	bNetUseOwnerRelevancy = true;
+
+}
+
+// Called when the game starts or when spawned
+void AItem::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Initial dormancy is for items placed in the level, spawned items go dormant after their first replication
+	if (HasAuthority() && !IsNetStartupActor() && NetDormancy == DORM_Initial)
+	{
+		SetNetDormancy(DORM_DormantAll);
+	}
+
+	ApplyItemState();
+	
+}
+
+void AItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Batches are thrown away with the world, only single items leaving a running world remove their instance
+	const bool bLeavingWorld = EndPlayReason == EEndPlayReason::Destroyed || EndPlayReason == EEndPlayReason::RemovedFromWorld;
+	if (bDrawnAsInstance && bLeavingWorld)
+	{
+		if (UShooterItemRenderSubsystem* ItemRender = GetWorld()->GetSubsystem<UShooterItemRenderSubsystem>())
+		{
+			ItemRender->RemoveItem(this, DroppedMesh);
+		}
+	}
+	bDrawnAsInstance = false;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AItem::SetItemState(EItemState NewState)
+{
+	if (ItemState != NewState)
+	{
+		ItemState = NewState;
+		if (HasActorBegunPlay())
+		{
+			ApplyItemState();
+		}
+
+		// Wakes up for one net update carrying the state, attachment and transform, then goes dormant again
+		if (HasAuthority())
+		{
+			FlushNetDormancy();
+			ForceNetUpdate();
+		}
+	}
+}
+
+void AItem::OnRep_ItemState()
+{
+	if (HasActorBegunPlay())
+	{
+		ApplyItemState();
+	}
+}
+
+void AItem::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AItem, ItemState);
+}
+
+bool AItem::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+	INC_DWORD_STAT(STAT_ShooterItemRelevancyChecks);
+
+	// Held items follow their owner
+	if (ItemState != EItemState::EIS_Dropped)
+	{
+		return Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation);
+	}
+	if (bAlwaysRelevant || IsOwnedBy(ViewTarget) || IsOwnedBy(RealViewer) || this == ViewTarget)
+	{
+		return true;
+	}
+
+	// Only reached for items that are awake, dormant ones are skipped by the net driver
+	return IsWithinNetRelevancyDistance(SrcLocation);
+}
+
+void AItem::ApplyItemState()
+{
+	// Items without a dropped mesh keep drawing their skeletal mesh
+	const bool bUseInstance = ItemState == EItemState::EIS_Dropped && DroppedMesh != nullptr;
+	UShooterItemRenderSubsystem* ItemRender = GetWorld()->GetSubsystem<UShooterItemRenderSubsystem>();
+	if (ItemRender && bUseInstance != bDrawnAsInstance)
+	{
+		if (bUseInstance)
+		{
+			ItemRender->AddItem(this, DroppedMesh, ItemMesh->GetComponentTransform());
+		}
+		else
+		{
+			ItemRender->RemoveItem(this, DroppedMesh);
+		}
+		bDrawnAsInstance = bUseInstance;
+	}
+
+	// Hidden skeletal mesh doesn't tick, animate or update bones
+	const bool bDrawSkeletalMesh = !bDrawnAsInstance && ItemState != EItemState::EIS_Stowed;
+	ItemMesh->SetVisibility(bDrawSkeletalMesh);
+	ItemMesh->SetComponentTickEnabled(bDrawSkeletalMesh);
+	ItemMesh->bNoSkeletonUpdate = !bDrawSkeletalMesh;
+
+	// Equipped items can't be focused or picked up
+	CollisionBox->SetCollisionEnabled(ItemState == EItemState::EIS_Dropped ? ECollisionEnabled::QueryOnly : ECollisionEnabled::NoCollision);
+}
+
+// Called every frame
+void AItem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+}
+
@@ -1,42 +1,88 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
-#include "Item.generated.h"
-
-UCLASS()
-class SHOOTERPROJESI_API AItem : public AActor
-{
-	GENERATED_BODY()
-	
-public:	
-	// Sets default values for this actor's properties
-	AItem();
-
-protected:
-	// Called when the game starts or when spawned
-	virtual void BeginPlay() override;
-
-public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
-private:
-	// Skeletal Mesh for Item
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
-	class USkeletalMeshComponent* ItemMesh;
-
-	// Line trace collides with box to show HUD widgets
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
-	class UBoxComponent* CollisionBox;
-
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
-	class UWidgetComponent* PickupWidget;
-
-
-public:
-
-
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Item.generated.h"
+
+UENUM(BlueprintType)
+enum class EItemState : uint8
+{
+	EIS_Dropped UMETA(DisplayName = "Dropped"),		// Lying in the world, drawn as an instance of DroppedMesh
+	EIS_Equipped UMETA(DisplayName = "Equipped"),	// Held by a character, drawn with the skeletal ItemMesh
+	EIS_Stowed UMETA(DisplayName = "Stowed"),		// In a character's weapon pool but not in hand, not drawn
+
+	EIS_MAX UMETA(Hidden)
+};
+
+/*
+	Pickup or weapon. Replicated but net dormant, an item only wakes up for a net update when its state changes, i.e. when
+	it is picked up, stowed or dropped, so idle items cost the server nothing per net tick. Equipped and stowed items use
+	their owner's relevancy, dropped items are relevant within NetCullDistanceSquared. Dormancy is what keeps idle items cheap,
+	the relevancy check itself is a single distance test.
+*/
+UCLASS()
+class SHOOTERPROJESI_API AItem : public AActor
+{
+	GENERATED_BODY()
+	
+public:	
+	// Sets default values for this actor's properties
+	AItem();
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Switches between the instanced and skeletal representation for the current state
+	void ApplyItemState();
+
+	UFUNCTION()
+	void OnRep_ItemState();
+
+public:	
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+
+private:
+	// Skeletal Mesh for Item
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	class USkeletalMeshComponent* ItemMesh;
+
+	// Line trace collides with box to show HUD widgets
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	class UBoxComponent* CollisionBox;
+
+	// Where the HUD's pickup widget is anchored, relative to the item
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true", MakeEditWidget = "true"))
+	FVector PickupWidgetOffset;
+
+	// Drawn instead of ItemMesh while dropped, batched with every other dropped item using the same mesh
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	class UStaticMesh* DroppedMesh;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_ItemState, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	EItemState ItemState;
+
+	// True while an instance of DroppedMesh is drawn for this item
+	bool bDrawnAsInstance;
+
+
+public:
+	void SetItemState(EItemState NewState);
+
+	FORCEINLINE EItemState GetItemState() const { return ItemState; }
+
+	FORCEINLINE USkeletalMeshComponent* GetItemMesh() const { return ItemMesh; }
+
+	FORCEINLINE FVector GetPickupWidgetLocation() const { return GetActorTransform().TransformPosition(PickupWidgetOffset); }
+
+
+};
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SShooterCrosshair.h"
+#include "Styling/SlateBrush.h"
+#include "Rendering/DrawElements.h"
+
+void SShooterCrosshair::Construct(const FArguments& InArgs)
+{
+	TopBrush = InArgs._TopBrush;
+	BottomBrush = InArgs._BottomBrush;
+	LeftBrush = InArgs._LeftBrush;
+	RightBrush = InArgs._RightBrush;
+	ElementSize = InArgs._ElementSize;
+	SpreadOffset = InArgs._SpreadOffset;
+	SpreadMultiplier = 0.f;
+
+	SetCanTick(false);
+}
+
+void SShooterCrosshair::SetSpreadMultiplier(float InSpreadMultiplier)
+{
+	if (SpreadMultiplier != InSpreadMultiplier)
+	{
+		SpreadMultiplier = InSpreadMultiplier;
+		// Element positions only, layout is unchanged
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+}
+
+int32 SShooterCrosshair::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	struct FCrosshairElement
+	{
+		const FSlateBrush* Brush;
+		FVector2D Direction;
+	};
+	const FCrosshairElement Elements[] =
+	{
+		{ TopBrush, FVector2D(0.f, -1.f) },
+		{ BottomBrush, FVector2D(0.f, 1.f) },
+		{ LeftBrush, FVector2D(-1.f, 0.f) },
+		{ RightBrush, FVector2D(1.f, 0.f) },
+	};
+
+	const FVector2D Center = AllottedGeometry.GetLocalSize() * 0.5f;
+	const float Offset = SpreadMultiplier * SpreadOffset;
+	for (const FCrosshairElement& Element : Elements)
+	{
+		if (Element.Brush == nullptr || Element.Brush->DrawAs == ESlateBrushDrawType::NoDrawType)
+		{
+			continue;
+		}
+		const FVector2D Position = Center + Element.Direction * Offset - ElementSize * 0.5f;
+		FSlateDrawElement::MakeBox(
+			OutDrawElements,
+			LayerId,
+			AllottedGeometry.ToPaintGeometry(Position, ElementSize),
+			Element.Brush,
+			ESlateDrawEffect::None,
+			InWidgetStyle.GetColorAndOpacityTint() * Element.Brush->GetTint(InWidgetStyle));
+	}
+	return LayerId;
+}
+
+FVector2D SShooterCrosshair::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return ElementSize;
+}
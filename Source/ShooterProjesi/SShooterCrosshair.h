@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+
+struct FSlateBrush;
+
+/*
+	The four crosshair elements drawn straight from the character's spread multiplier.
+	Only repaints when SetSpreadMultiplier changes the value, so it is cheap inside an invalidation panel.
+*/
+class SHOOTERPROJESI_API SShooterCrosshair : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SShooterCrosshair)
+		: _TopBrush(nullptr)
+		, _BottomBrush(nullptr)
+		, _LeftBrush(nullptr)
+		, _RightBrush(nullptr)
+		, _ElementSize(FVector2D(64.f, 64.f))
+		, _SpreadOffset(16.f)
+	{}
+		// Brushes are owned by the HUD and must outlive the widget
+		SLATE_ARGUMENT(const FSlateBrush*, TopBrush)
+		SLATE_ARGUMENT(const FSlateBrush*, BottomBrush)
+		SLATE_ARGUMENT(const FSlateBrush*, LeftBrush)
+		SLATE_ARGUMENT(const FSlateBrush*, RightBrush)
+
+		// Size of each element in slate units
+		SLATE_ARGUMENT(FVector2D, ElementSize)
+
+		// Distance an element moves away from the center per unit of spread multiplier
+		SLATE_ARGUMENT(float, SpreadOffset)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	void SetSpreadMultiplier(float InSpreadMultiplier);
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+
+protected:
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+	const FSlateBrush* TopBrush;
+	const FSlateBrush* BottomBrush;
+	const FSlateBrush* LeftBrush;
+	const FSlateBrush* RightBrush;
+
+	FVector2D ElementSize;
+
+	float SpreadOffset;
+
+	float SpreadMultiplier;
+};
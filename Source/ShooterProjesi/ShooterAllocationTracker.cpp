@@ -0,0 +1,260 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterAllocationTracker.h"
+#include "ShooterProjesi.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectBase.h"
+
+static TAutoConsoleVariable<int32> CVarAllocsEnabled(
+	TEXT("Shooter.Allocs.Enabled"),
+	0,
+	TEXT("Count heap allocations and UObjects per gameplay action. Installs a counting malloc proxy the first time it is used"));
+
+// Forwards everything to the engine allocator, counts game thread allocations for the tracker
+class FShooterCountingMalloc final : public FMalloc
+{
+public:
+	FShooterCountingMalloc(FMalloc* InInnerMalloc, FShooterAllocationTracker& InTracker)
+		: InnerMalloc(InInnerMalloc)
+		, Tracker(InTracker)
+	{
+	}
+
+	virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+	{
+		Count(Size);
+		return InnerMalloc->Malloc(Size, Alignment);
+	}
+
+	virtual void* TryMalloc(SIZE_T Size, uint32 Alignment) override
+	{
+		Count(Size);
+		return InnerMalloc->TryMalloc(Size, Alignment);
+	}
+
+	virtual void* Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		Count(NewSize);
+		return InnerMalloc->Realloc(Ptr, NewSize, Alignment);
+	}
+
+	virtual void* TryRealloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		Count(NewSize);
+		return InnerMalloc->TryRealloc(Ptr, NewSize, Alignment);
+	}
+
+	virtual void Free(void* Ptr) override
+	{
+		InnerMalloc->Free(Ptr);
+	}
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+	{
+		return InnerMalloc->GetAllocationSize(Original, SizeOut);
+	}
+
+	virtual SIZE_T QuantizeSize(SIZE_T Size, uint32 Alignment) override
+	{
+		return InnerMalloc->QuantizeSize(Size, Alignment);
+	}
+
+	virtual void Trim(bool bTrimThreadCaches) override
+	{
+		InnerMalloc->Trim(bTrimThreadCaches);
+	}
+
+	virtual void SetupTLSCachesOnCurrentThread() override
+	{
+		InnerMalloc->SetupTLSCachesOnCurrentThread();
+	}
+
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+	{
+		InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+	}
+
+	virtual void InitializeStatsMetadata() override
+	{
+		InnerMalloc->InitializeStatsMetadata();
+	}
+
+	virtual void UpdateStats() override
+	{
+		InnerMalloc->UpdateStats();
+	}
+
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override
+	{
+		InnerMalloc->GetAllocatorStats(OutStats);
+	}
+
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+	{
+		InnerMalloc->DumpAllocatorStats(Ar);
+	}
+
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return InnerMalloc->IsInternallyThreadSafe();
+	}
+
+	virtual bool ValidateHeap() override
+	{
+		return InnerMalloc->ValidateHeap();
+	}
+
+	virtual bool Exec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar) override
+	{
+		return InnerMalloc->Exec(InWorld, Cmd, Ar);
+	}
+
+	virtual const TCHAR* GetDescriptiveName() override
+	{
+		return InnerMalloc->GetDescriptiveName();
+	}
+
+private:
+	FORCEINLINE void Count(SIZE_T Size)
+	{
+		if (IsInGameThread())
+		{
+			Tracker.CountAllocation(Size);
+		}
+	}
+
+	FMalloc* InnerMalloc;
+	FShooterAllocationTracker& Tracker;
+};
+
+FShooterAllocationTracker& FShooterAllocationTracker::Get()
+{
+	static FShooterAllocationTracker Tracker;
+	return Tracker;
+}
+
+FShooterAllocationTracker::FShooterAllocationTracker()
+	: bInstalled(false)
+	, ActiveScopes(0)
+{
+}
+
+void FShooterAllocationTracker::Install()
+{
+	bInstalled = true;
+
+	// Allocations already made through the engine allocator are freed through the proxy, which forwards them
+	GMalloc = new FShooterCountingMalloc(GMalloc, *this);
+	GUObjectArray.AddUObjectCreateListener(this);
+	UE_LOG(LogShooter, Display, TEXT("Allocation tracking installed"));
+}
+
+bool FShooterAllocationTracker::IsEnabled()
+{
+	return CVarAllocsEnabled.GetValueOnGameThread() != 0;
+}
+
+bool FShooterAllocationTracker::BeginScope(FCounts& OutStart)
+{
+	if (!IsInGameThread() || !IsEnabled())
+	{
+		return false;
+	}
+	if (!bInstalled)
+	{
+		Install();
+	}
+	OutStart = Counts;
+	++ActiveScopes;
+	return true;
+}
+
+void FShooterAllocationTracker::EndScope(FName Action, const FCounts& Start)
+{
+	// Stop counting before touching the map, its own allocations are not part of the action
+	const FCounts End = Counts;
+	--ActiveScopes;
+
+	FShooterActionAllocationStats& ActionStats = Stats.FindOrAdd(Action);
+	const int64 Allocations = End.Allocations - Start.Allocations;
+	++ActionStats.NumCalls;
+	ActionStats.Allocations += Allocations;
+	ActionStats.Bytes += End.Bytes - Start.Bytes;
+	ActionStats.Objects += End.Objects - Start.Objects;
+	ActionStats.MaxAllocations = FMath::Max(ActionStats.MaxAllocations, Allocations);
+}
+
+void FShooterAllocationTracker::ResetStats()
+{
+	Stats.Reset();
+}
+
+void FShooterAllocationTracker::NotifyUObjectCreated(const UObjectBase* Object, int32 Index)
+{
+	// Async loading creates objects on other threads
+	if (ActiveScopes > 0 && IsInGameThread())
+	{
+		++Counts.Objects;
+	}
+}
+
+void FShooterAllocationTracker::OnUObjectArrayShutdown()
+{
+	GUObjectArray.RemoveUObjectCreateListener(this);
+}
+
+void FShooterAllocationTracker::LogStats(const FString& Label, const TMap<FName, FShooterActionAllocationStats>& Current, const TMap<FName, FShooterActionAllocationStats>& Baseline)
+{
+	TArray<FName> Actions;
+	Current.GetKeys(Actions);
+	Actions.Sort(FNameLexicalLess());
+
+	bool bAnyCalls = false;
+	for (const FName Action : Actions)
+	{
+		FShooterActionAllocationStats ActionStats = Current.FindChecked(Action);
+		if (const FShooterActionAllocationStats* BaselineStats = Baseline.Find(Action))
+		{
+			ActionStats.NumCalls -= BaselineStats->NumCalls;
+			ActionStats.Allocations -= BaselineStats->Allocations;
+			ActionStats.Bytes -= BaselineStats->Bytes;
+			ActionStats.Objects -= BaselineStats->Objects;
+		}
+		if (ActionStats.NumCalls <= 0)
+		{
+			continue;
+		}
+		bAnyCalls = true;
+		// Max is over the whole run, it can't be split by baseline
+		UE_LOG(LogShooter, Display, TEXT("%s %s: %d calls, avg %.1f allocations (%.1f KB), avg %.2f UObjects, max %lld allocations"),
+			*Label,
+			*Action.ToString(),
+			ActionStats.NumCalls,
+			static_cast<double>(ActionStats.Allocations) / ActionStats.NumCalls,
+			static_cast<double>(ActionStats.Bytes) / ActionStats.NumCalls / 1024.0,
+			static_cast<double>(ActionStats.Objects) / ActionStats.NumCalls,
+			ActionStats.MaxAllocations);
+	}
+	if (!bAnyCalls)
+	{
+		UE_LOG(LogShooter, Display, TEXT("%s: no tracked actions%s"), *Label, !IsEnabled() ? TEXT(", set Shooter.Allocs.Enabled 1") : TEXT(""));
+	}
+}
+
+static FAutoConsoleCommand AllocsDumpCommand(
+	TEXT("Shooter.Allocs.Dump"),
+	TEXT("Logs average heap allocations and UObjects per gameplay action since the last reset"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FShooterAllocationTracker::LogStats(TEXT("Allocations"), FShooterAllocationTracker::Get().GetStats());
+	}));
+
+static FAutoConsoleCommand AllocsResetCommand(
+	TEXT("Shooter.Allocs.Reset"),
+	TEXT("Clears the per action allocation stats"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FShooterAllocationTracker::Get().ResetStats();
+	}));
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/UObjectArray.h"
+
+// Totals of one gameplay action, divide by NumCalls for the per call average
+struct FShooterActionAllocationStats
+{
+	int32 NumCalls = 0;
+	int64 Allocations = 0;
+	int64 Bytes = 0;
+	int64 Objects = 0;
+	int64 MaxAllocations = 0;
+};
+
+/*
+	Counts the heap allocations and UObjects created on the game thread inside SHOOTER_ALLOCATION_SCOPE, per action.
+	Off by default, setting Shooter.Allocs.Enabled wraps GMalloc in a counting proxy the first time a scope runs.
+	The proxy stays installed until exit since other threads may be inside it, with no scope open it only forwards.
+	Nested scopes are inclusive, an action's numbers contain the actions it calls.
+*/
+class SHOOTERPROJESI_API FShooterAllocationTracker : public FUObjectArray::FUObjectCreateListener
+{
+public:
+	struct FCounts
+	{
+		int64 Allocations = 0;
+		int64 Bytes = 0;
+		int64 Objects = 0;
+	};
+
+	static FShooterAllocationTracker& Get();
+
+	// Shooter.Allocs.Enabled
+	static bool IsEnabled();
+
+	// False when tracking is off, EndScope must only be called for scopes that began
+	bool BeginScope(FCounts& OutStart);
+
+	void EndScope(FName Action, const FCounts& Start);
+
+	FORCEINLINE const TMap<FName, FShooterActionAllocationStats>& GetStats() const { return Stats; }
+
+	void ResetStats();
+
+	// Logs the per call averages, stats in Baseline are subtracted first so a benchmark phase can report only its own calls
+	static void LogStats(const FString& Label, const TMap<FName, FShooterActionAllocationStats>& Current, const TMap<FName, FShooterActionAllocationStats>& Baseline = {});
+
+	// Proxy callback, game thread only
+	FORCEINLINE void CountAllocation(SIZE_T Size)
+	{
+		if (ActiveScopes > 0)
+		{
+			++Counts.Allocations;
+			Counts.Bytes += Size;
+		}
+	}
+
+	virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override;
+
+	virtual void OnUObjectArrayShutdown() override;
+
+private:
+	FShooterAllocationTracker();
+
+	void Install();
+
+	bool bInstalled;
+
+	int32 ActiveScopes;
+
+	// Running totals while a scope is open
+	FCounts Counts;
+
+	TMap<FName, FShooterActionAllocationStats> Stats;
+};
+
+class FShooterAllocationScope
+{
+public:
+	explicit FShooterAllocationScope(FName InAction)
+		: Action(InAction)
+	{
+		bActive = FShooterAllocationTracker::Get().BeginScope(Start);
+	}
+
+	~FShooterAllocationScope()
+	{
+		if (bActive)
+		{
+			FShooterAllocationTracker::Get().EndScope(Action, Start);
+		}
+	}
+
+private:
+	FName Action;
+	FShooterAllocationTracker::FCounts Start;
+	bool bActive;
+};
+
+// The action name is made once per call site, not per call
+#define SHOOTER_ALLOCATION_SCOPE(Action) \
+	static const FName PREPROCESSOR_JOIN(AllocationAction_, __LINE__)(TEXT(Action)); \
+	FShooterAllocationScope PREPROCESSOR_JOIN(AllocationScope_, __LINE__)(PREPROCESSOR_JOIN(AllocationAction_, __LINE__))
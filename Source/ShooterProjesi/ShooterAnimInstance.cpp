@@ -1,49 +1,123 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "ShooterAnimInstance.h"
-#include "ShooterCharacter.h"
-#include "GameFramework/CharacterMovementComponent.h"
-#include "Kismet/KismetMathLibrary.h"
-
-void UShooterAnimInstance::UpdateAnimationProperties(float DeltaTime)
-{
-	if (ShooterCharacter == nullptr)
-	{
-		ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
-	}
-	if (ShooterCharacter)
-	{
-		FVector Velocity = ShooterCharacter->GetVelocity();
-		Velocity.Z = 0;
-		Speed = Velocity.Size();
-
-		bIsInAir = ShooterCharacter->GetCharacterMovement()->IsFalling();
-
-		if (ShooterCharacter->GetCharacterMovement()->GetCurrentAcceleration().Size() > 0.f)
-		{
-			bIsAccelerating = true; // this is not real acceleration, it just checks if characters is moving or not
-		}
-		else
-		{
-			bIsAccelerating = false;
-		}
-		FRotator AimRotation = ShooterCharacter->GetBaseAimRotation();
-		FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX(ShooterCharacter->GetVelocity());
-		
-		MovementOffSetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, AimRotation).Yaw;
-
-		if (ShooterCharacter->GetVelocity().Size() > 0.f)
-		{
-			LastMovementOffSetYaw = MovementOffSetYaw;
-		}
-
-		bAiming = ShooterCharacter->GetAiming(); 
-	}
-}
-
-void UShooterAnimInstance::NativeInitializeAnimation()
-{
-
-	ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
-}
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterAnimInstance.h"
+#include "ShooterCharacter.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Kismet/KismetMathLibrary.h"
+
+UShooterAnimInstance::UShooterAnimInstance()
+{
+	CharacterShotCounter = 0;
+	ProcessedShotCounter = 0;
+	RecoilSpringValue = 0.f;
+	RecoilSpringVelocity = 0.f;
+	RecoilAlpha = 0.f;
+	RecoilPitch = 0.f;
+	RecoilKickback = 0.f;
+
+	// Peaks around 1 roughly 50ms after a shot and settles in ~0.25 second
+	RecoilImpulse = 55.f;
+	RecoilStiffness = 400.f;
+	RecoilDampingRatio = 1.f;
+	MaxRecoilPitch = 6.f;
+	MaxRecoilKickback = 4.f;
+}
+
+void UShooterAnimInstance::UpdateAnimationProperties(float DeltaTime)
+{
+	if (ShooterCharacter == nullptr)
+	{
+		ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+	}
+	if (ShooterCharacter)
+	{
+		FVector Velocity = ShooterCharacter->GetVelocity();
+		Velocity.Z = 0;
+		Speed = Velocity.Size();
+
+		bIsInAir = ShooterCharacter->GetCharacterMovement()->IsFalling();
+
+		if (ShooterCharacter->GetCharacterMovement()->GetCurrentAcceleration().Size() > 0.f)
+		{
+			bIsAccelerating = true; // this is not real acceleration, it just checks if characters is moving or not
+		}
+		else
+		{
+			bIsAccelerating = false;
+		}
+		FRotator AimRotation = ShooterCharacter->GetBaseAimRotation();
+		FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX(ShooterCharacter->GetVelocity());
+		
+		MovementOffSetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, AimRotation).Yaw;
+
+		if (ShooterCharacter->GetVelocity().Size() > 0.f)
+		{
+			LastMovementOffSetYaw = MovementOffSetYaw;
+		}
+
+		bAiming = ShooterCharacter->GetAiming(); 
+	}
+}
+
+void UShooterAnimInstance::NativeInitializeAnimation()
+{
+
+	ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+	if (ShooterCharacter)
+	{
+		// Don't replay shots fired before this anim instance existed
+		CharacterShotCounter = ShooterCharacter->GetShotCounter();
+		ProcessedShotCounter = CharacterShotCounter;
+	}
+}
+
+void UShooterAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeUpdateAnimation(DeltaSeconds);
+
+	if (ShooterCharacter)
+	{
+		CharacterShotCounter = ShooterCharacter->GetShotCounter();
+	}
+}
+
+// Runs on a worker thread when multi threaded animation update is enabled, must only touch this anim instance's data
+void UShooterAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
+	// Every new shot kicks the spring, no montage instance is created
+	const uint32 NewShots = CharacterShotCounter - ProcessedShotCounter;
+	ProcessedShotCounter = CharacterShotCounter;
+	if (NewShots > 0)
+	{
+		RecoilSpringVelocity += RecoilImpulse * FMath::Min(NewShots, 3u);
+	}
+
+	if (RecoilSpringValue == 0.f && RecoilSpringVelocity == 0.f)
+	{
+		return; // At rest
+	}
+
+	// Damped spring towards 0, semi implicit euler with small sub steps so hitches stay stable
+	const float Damping = 2.f * RecoilDampingRatio * FMath::Sqrt(RecoilStiffness);
+	float RemainingTime = FMath::Min(DeltaSeconds, 0.1f);
+	while (RemainingTime > 0.f)
+	{
+		const float Step = FMath::Min(RemainingTime, 1.f / 120.f);
+		RecoilSpringVelocity += (-RecoilStiffness * RecoilSpringValue - Damping * RecoilSpringVelocity) * Step;
+		RecoilSpringValue += RecoilSpringVelocity * Step;
+		RemainingTime -= Step;
+	}
+
+	if (FMath::Abs(RecoilSpringValue) < KINDA_SMALL_NUMBER && FMath::Abs(RecoilSpringVelocity) < KINDA_SMALL_NUMBER)
+	{
+		RecoilSpringValue = 0.f;
+		RecoilSpringVelocity = 0.f;
+	}
+
+	RecoilAlpha = FMath::Clamp(RecoilSpringValue, 0.f, 1.f);
+	RecoilPitch = RecoilSpringValue * MaxRecoilPitch;
+	RecoilKickback = RecoilSpringValue * MaxRecoilKickback;
+}
@@ -1,53 +1,104 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Animation/AnimInstance.h"
-#include "ShooterAnimInstance.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class SHOOTERPROJESI_API UShooterAnimInstance : public UAnimInstance
-{
-	GENERATED_BODY()
-public:
-
-		UFUNCTION(BlueprintCallable)
-		void UpdateAnimationProperties(float DeltaTime); // this is tick() funticon for animation
-
-		virtual void NativeInitializeAnimation() override; // this is like beginplay() function for animation
-
-private:
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess="true"))
-	class AShooterCharacter* ShooterCharacter;
-
-	// Character's speed
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Movement", meta =(AllowPrivateAccess="true"))
-	float Speed;
-
-	// Is Character in air
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
-	bool bIsInAir;
-
-	// Is Character moving
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
-	bool bIsAccelerating;
-
-	// OffSet Yaw used for strafing 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement", meta = (AllowPrivateAccess = "true"))
-	float MovementOffSetYaw;
-
-	// Offset yaw value before the character stop 
-	/*
-		We need this value for the stop animation blend space 
-	*/
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement", meta = (AllowPrivateAccess = "true"))
-	float LastMovementOffSetYaw;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess= "true"))
-	bool bAiming;
-
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "ShooterAnimInstance.generated.h"
+
+/**
+ * 
+ */
+UCLASS()
+class SHOOTERPROJESI_API UShooterAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+public:
+
+		UFUNCTION(BlueprintCallable)
+		void UpdateAnimationProperties(float DeltaTime); // this is tick() funticon for animation
+
+		virtual void NativeInitializeAnimation() override; // this is like beginplay() function for animation
+
+		virtual void NativeUpdateAnimation(float DeltaSeconds) override; // game thread, only copies data from the character
+
+		virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override; // worker thread, evaluates procedural recoil
+
+private:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess="true"))
+	class AShooterCharacter* ShooterCharacter;
+
+	// Character's speed
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Movement", meta =(AllowPrivateAccess="true"))
+	float Speed;
+
+	// Is Character in air
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	bool bIsInAir;
+
+	// Is Character moving
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	bool bIsAccelerating;
+
+	// OffSet Yaw used for strafing 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	float MovementOffSetYaw;
+
+	// Offset yaw value before the character stop 
+	/*
+		We need this value for the stop animation blend space 
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement", meta = (AllowPrivateAccess = "true"))
+	float LastMovementOffSetYaw;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Movement", meta = (AllowPrivateAccess= "true"))
+	bool bAiming;
+
+	// Shot counter copied from the character on the game thread
+	uint32 CharacterShotCounter;
+
+	// Shot counter already turned into recoil impulses
+	uint32 ProcessedShotCounter;
+
+	// Current recoil spring value, 0 at rest 1 after a single shot
+	float RecoilSpringValue;
+
+	// Current recoil spring velocity
+	float RecoilSpringVelocity;
+
+	// Blend weight for the additive recoil layer
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Recoil", meta = (AllowPrivateAccess = "true"))
+	float RecoilAlpha;
+
+	// Weapon pitch kick in degrees, applied additively to the hand/spine bones
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Recoil", meta = (AllowPrivateAccess = "true"))
+	float RecoilPitch;
+
+	// Weapon kick back along the aim direction in units
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Recoil", meta = (AllowPrivateAccess = "true"))
+	float RecoilKickback;
+
+	// Velocity added to the recoil spring per shot
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Recoil", meta = (AllowPrivateAccess = "true"))
+	float RecoilImpulse;
+
+	// Stiffness of the recoil spring, higher values recover faster
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Recoil", meta = (AllowPrivateAccess = "true"))
+	float RecoilStiffness;
+
+	// Damping ratio of the recoil spring, 1 is critically damped
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Recoil", meta = (AllowPrivateAccess = "true"))
+	float RecoilDampingRatio;
+
+	// Pitch in degrees at RecoilAlpha 1
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Recoil", meta = (AllowPrivateAccess = "true"))
+	float MaxRecoilPitch;
+
+	// Kick back in units at RecoilAlpha 1
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Recoil", meta = (AllowPrivateAccess = "true"))
+	float MaxRecoilKickback;
+
+public:
+	UShooterAnimInstance();
+
+};
@@ -0,0 +1,450 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterBenchmark.h"
+#include "ShooterProjesi.h"
+#include "ShooterCharacter.h"
+#include "Drone.h"
+#include "DroneSwarm.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "RenderCore.h"
+
+FShooterFrameBenchmark::FShooterFrameBenchmark(const FString& InName, UWorld* InWorld, int32 InFramesPerPhase, int32 InWarmupFrames)
+	: Name(InName)
+	, World(InWorld)
+	, FramesPerPhase(FMath::Max(InFramesPerPhase, 1))
+	, WarmupFrames(FMath::Max(InWarmupFrames, 0))
+	, PhaseIndex(INDEX_NONE)
+	, PhaseFrame(0)
+	, TotalFrameMs(0.0)
+	, TotalGameThreadMs(0.0)
+	, MaxGameThreadMs(0.0)
+{
+}
+
+void FShooterFrameBenchmark::AddPhase(const FShooterBenchmarkPhase& Phase)
+{
+	Phases.Add(Phase);
+}
+
+void FShooterFrameBenchmark::Run()
+{
+	if (Phases.Num() == 0 || !World.IsValid() || TickerHandle.IsValid())
+	{
+		return;
+	}
+	UE_LOG(LogShooter, Display, TEXT("Benchmark %s: %d phases, %d frames each"), *Name, Phases.Num(), FramesPerPhase);
+
+	SelfReference = AsShared();
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FShooterFrameBenchmark::Tick));
+}
+
+bool FShooterFrameBenchmark::Tick(float DeltaTime)
+{
+	UWorld* BenchmarkWorld = World.Get();
+	if (BenchmarkWorld == nullptr)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Benchmark %s: world went away, aborting"), *Name);
+		SelfReference.Reset();
+		return false;
+	}
+
+	// Start next phase
+	if (PhaseIndex == INDEX_NONE || PhaseFrame >= WarmupFrames + FramesPerPhase)
+	{
+		if (PhaseIndex != INDEX_NONE)
+		{
+			LogPhaseResult();
+			if (Phases[PhaseIndex].End)
+			{
+				Phases[PhaseIndex].End(BenchmarkWorld);
+			}
+		}
+
+		++PhaseIndex;
+		if (!Phases.IsValidIndex(PhaseIndex))
+		{
+			UE_LOG(LogShooter, Display, TEXT("Benchmark %s: done"), *Name);
+			SelfReference.Reset();
+			return false;
+		}
+
+		PhaseFrame = 0;
+		TotalFrameMs = 0.0;
+		TotalGameThreadMs = 0.0;
+		MaxGameThreadMs = 0.0;
+		if (Phases[PhaseIndex].Begin)
+		{
+			Phases[PhaseIndex].Begin(BenchmarkWorld);
+		}
+	}
+
+	if (PhaseFrame == WarmupFrames)
+	{
+		AllocationBaseline = FShooterAllocationTracker::Get().GetStats();
+	}
+	if (Phases[PhaseIndex].Frame)
+	{
+		Phases[PhaseIndex].Frame(BenchmarkWorld, PhaseFrame);
+	}
+
+	// Timings of the previous frame, skip the warmup frames
+	if (PhaseFrame >= WarmupFrames)
+	{
+		const double GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+		TotalFrameMs += DeltaTime * 1000.0;
+		TotalGameThreadMs += GameThreadMs;
+		MaxGameThreadMs = FMath::Max(MaxGameThreadMs, GameThreadMs);
+	}
+	++PhaseFrame;
+	return true;
+}
+
+void FShooterFrameBenchmark::LogPhaseResult() const
+{
+	UE_LOG(LogShooter, Display, TEXT("Benchmark %s [%s]: avg frame %.3f ms, avg game thread %.3f ms, max game thread %.3f ms"),
+		*Name,
+		*Phases[PhaseIndex].Name,
+		TotalFrameMs / FramesPerPhase,
+		TotalGameThreadMs / FramesPerPhase,
+		MaxGameThreadMs);
+	if (FShooterAllocationTracker::IsEnabled())
+	{
+		FShooterAllocationTracker::LogStats(FString::Printf(TEXT("Benchmark %s [%s]"), *Name, *Phases[PhaseIndex].Name), FShooterAllocationTracker::Get().GetStats(), AllocationBaseline);
+	}
+}
+
+// Spawns Count characters of the local player's class in a grid in front of the player
+static TArray<TWeakObjectPtr<AShooterCharacter>> SpawnBenchmarkCharacters(UWorld* World, int32 Count)
+{
+	TArray<TWeakObjectPtr<AShooterCharacter>> Characters;
+	APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(World, 0);
+	if (PlayerPawn == nullptr || !PlayerPawn->IsA<AShooterCharacter>())
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Benchmark needs a local AShooterCharacter to copy"));
+		return Characters;
+	}
+
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Count)));
+	const FVector Origin = PlayerPawn->GetActorLocation() + PlayerPawn->GetActorForwardVector() * 300.f;
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const FVector Location = Origin + FVector((Index / GridSize) * 150.f, (Index % GridSize) * 150.f, 0.f);
+		AShooterCharacter* Character = World->SpawnActor<AShooterCharacter>(PlayerPawn->GetClass(), Location, PlayerPawn->GetActorRotation(), SpawnParams);
+		if (Character)
+		{
+			Characters.Add(Character);
+		}
+	}
+	return Characters;
+}
+
+static void DestroyBenchmarkCharacters(TArray<TWeakObjectPtr<AShooterCharacter>>& Characters)
+{
+	for (TWeakObjectPtr<AShooterCharacter>& Character : Characters)
+	{
+		if (Character.IsValid())
+		{
+			Character->Destroy();
+		}
+	}
+	Characters.Reset();
+}
+
+// Shooter.Bench.Recoil [Characters=50] [Frames=300]
+// Fires 10 shots per second (at 60 fps) on every character, first with HipFireMontage then with the procedural layer
+static void RunRecoilBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	const int32 NumCharacters = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 50;
+	const int32 NumFrames = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 300;
+
+	TSharedRef<TArray<TWeakObjectPtr<AShooterCharacter>>> Characters = MakeShared<TArray<TWeakObjectPtr<AShooterCharacter>>>();
+	TSharedRef<FShooterFrameBenchmark> Benchmark = MakeShared<FShooterFrameBenchmark>(TEXT("Recoil"), World, NumFrames);
+
+	for (const bool bProcedural : { false, true })
+	{
+		FShooterBenchmarkPhase Phase;
+		Phase.Name = bProcedural ? TEXT("Procedural") : TEXT("Montage");
+		Phase.Begin = [Characters, NumCharacters, bProcedural](UWorld* InWorld)
+		{
+			*Characters = SpawnBenchmarkCharacters(InWorld, NumCharacters);
+			for (TWeakObjectPtr<AShooterCharacter>& Character : *Characters)
+			{
+				Character->SetUseProceduralRecoil(bProcedural);
+			}
+		};
+		Phase.Frame = [Characters](UWorld* InWorld, int32 Frame)
+		{
+			if (Frame % 6 != 0)
+			{
+				return;
+			}
+			for (TWeakObjectPtr<AShooterCharacter>& Character : *Characters)
+			{
+				if (Character.IsValid())
+				{
+					Character->PlayRecoil();
+				}
+			}
+		};
+		Phase.End = [Characters](UWorld* InWorld)
+		{
+			DestroyBenchmarkCharacters(*Characters);
+		};
+		Benchmark->AddPhase(Phase);
+	}
+	Benchmark->Run();
+}
+
+static FAutoConsoleCommandWithWorldAndArgs RecoilBenchmarkCommand(
+	TEXT("Shooter.Bench.Recoil"),
+	TEXT("Compares anim cost of montage and procedural recoil. Usage: Shooter.Bench.Recoil [Characters=50] [Frames=300]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunRecoilBenchmark));
+
+// Shooter.Bench.DroneMovement [Drones=200] [Frames=300]
+// Flies the same number of drones in circles with physics simulation and with the kinematic movement component
+static void RunDroneMovementBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	const int32 NumDrones = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 200;
+	const int32 NumFrames = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 300;
+
+	AShooterCharacter* PlayerCharacter = Cast<AShooterCharacter>(UGameplayStatics::GetPlayerPawn(World, 0));
+	if (PlayerCharacter == nullptr || PlayerCharacter->GetDroneClass() == nullptr)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Shooter.Bench.DroneMovement needs a local AShooterCharacter with a drone class"));
+		return;
+	}
+	const TSubclassOf<APawn> DroneClass = PlayerCharacter->GetDroneClass();
+	const FVector Origin = PlayerCharacter->GetActorLocation() + FVector(0.f, 0.f, 1'000.f);
+
+	TSharedRef<TArray<TWeakObjectPtr<ADrone>>> Drones = MakeShared<TArray<TWeakObjectPtr<ADrone>>>();
+	TSharedRef<FShooterFrameBenchmark> Benchmark = MakeShared<FShooterFrameBenchmark>(TEXT("DroneMovement"), World, NumFrames);
+
+	for (const EDroneMovementMode Mode : { EDroneMovementMode::EDMM_Physics, EDroneMovementMode::EDMM_Kinematic })
+	{
+		FShooterBenchmarkPhase Phase;
+		Phase.Name = Mode == EDroneMovementMode::EDMM_Physics ? TEXT("Physics") : TEXT("Kinematic");
+		Phase.Begin = [Drones, NumDrones, DroneClass, Origin, Mode](UWorld* InWorld)
+		{
+			const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumDrones)));
+			for (int32 Index = 0; Index < NumDrones; ++Index)
+			{
+				const FTransform Transform(Origin + FVector((Index / GridSize) * 200.f, (Index % GridSize) * 200.f, 0.f));
+				ADrone* Drone = InWorld->SpawnActorDeferred<ADrone>(DroneClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+				if (Drone)
+				{
+					Drone->SetDroneMovementMode(Mode);
+					Drone->FinishSpawning(Transform);
+					Drones->Add(Drone);
+				}
+			}
+		};
+		Phase.Frame = [Drones](UWorld* InWorld, int32 Frame)
+		{
+			// Keep every drone moving so neither mode gets to sleep
+			const float Angle = Frame * 0.05f;
+			const FVector Velocity(FMath::Cos(Angle) * 400.f, FMath::Sin(Angle) * 400.f, 0.f);
+			for (TWeakObjectPtr<ADrone>& Drone : *Drones)
+			{
+				if (Drone.IsValid())
+				{
+					Drone->SetDroneVelocity(Velocity);
+				}
+			}
+		};
+		Phase.End = [Drones](UWorld* InWorld)
+		{
+			for (TWeakObjectPtr<ADrone>& Drone : *Drones)
+			{
+				if (Drone.IsValid())
+				{
+					Drone->Destroy();
+				}
+			}
+			Drones->Reset();
+		};
+		Benchmark->AddPhase(Phase);
+	}
+	Benchmark->Run();
+}
+
+static FAutoConsoleCommandWithWorldAndArgs DroneMovementBenchmarkCommand(
+	TEXT("Shooter.Bench.DroneMovement"),
+	TEXT("Compares physics and kinematic drone flight cost. Usage: Shooter.Bench.DroneMovement [Drones=200] [Frames=300]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunDroneMovementBenchmark));
+
+// Shooter.Bench.PawnSwitch [Frames=300] [FramesPerSwitch=2]
+// Switches the player between character and drone, first with full re-possession then with the fast input/view target swap
+static void RunPawnSwitchBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	const int32 NumFrames = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 300;
+	const int32 FramesPerSwitch = FMath::Max(Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 2, 1);
+
+	AShooterCharacter* PlayerCharacter = Cast<AShooterCharacter>(UGameplayStatics::GetPlayerPawn(World, 0));
+	if (PlayerCharacter == nullptr || PlayerCharacter->GetDroneClass() == nullptr)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Shooter.Bench.PawnSwitch needs a local AShooterCharacter with a drone class"));
+		return;
+	}
+	const TWeakObjectPtr<AShooterCharacter> Character = PlayerCharacter;
+
+	struct FSwitchTimes
+	{
+		int32 NumSwitches = 0;
+		double TotalMs = 0.0;
+		double MaxMs = 0.0;
+	};
+	TSharedRef<FSwitchTimes> SwitchTimes = MakeShared<FSwitchTimes>();
+	TSharedRef<FShooterFrameBenchmark> Benchmark = MakeShared<FShooterFrameBenchmark>(TEXT("PawnSwitch"), World, NumFrames);
+
+	for (const bool bFast : { false, true })
+	{
+		FShooterBenchmarkPhase Phase;
+		Phase.Name = bFast ? TEXT("FastSwitch") : TEXT("Possess");
+		Phase.Begin = [Character, SwitchTimes, bFast](UWorld* InWorld)
+		{
+			*SwitchTimes = FSwitchTimes();
+			if (Character.IsValid())
+			{
+				Character->SetFastPawnSwitch(bFast);
+			}
+		};
+		Phase.Frame = [Character, SwitchTimes, FramesPerSwitch](UWorld* InWorld, int32 Frame)
+		{
+			if (!Character.IsValid() || Frame % FramesPerSwitch != 0)
+			{
+				return;
+			}
+			const double StartTime = FPlatformTime::Seconds();
+			if (Character->IsControllingDrone())
+			{
+				Character->DroneToPlayer();
+			}
+			else
+			{
+				Character->StartDroneControl();
+			}
+			const double SwitchMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+			++SwitchTimes->NumSwitches;
+			SwitchTimes->TotalMs += SwitchMs;
+			SwitchTimes->MaxMs = FMath::Max(SwitchTimes->MaxMs, SwitchMs);
+		};
+		Phase.End = [Character, SwitchTimes, bFast](UWorld* InWorld)
+		{
+			if (Character.IsValid())
+			{
+				Character->DroneToPlayer();
+			}
+			UE_LOG(LogShooter, Display, TEXT("Benchmark PawnSwitch [%s]: %d switches, avg %.3f ms, max %.3f ms per switch"),
+				bFast ? TEXT("FastSwitch") : TEXT("Possess"),
+				SwitchTimes->NumSwitches,
+				SwitchTimes->NumSwitches > 0 ? SwitchTimes->TotalMs / SwitchTimes->NumSwitches : 0.0,
+				SwitchTimes->MaxMs);
+		};
+		Benchmark->AddPhase(Phase);
+	}
+	Benchmark->Run();
+}
+
+static FAutoConsoleCommandWithWorldAndArgs PawnSwitchBenchmarkCommand(
+	TEXT("Shooter.Bench.PawnSwitch"),
+	TEXT("Compares drone switch cost of re-possession and the fast input/view swap. Usage: Shooter.Bench.PawnSwitch [Frames=300] [FramesPerSwitch=2]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunPawnSwitchBenchmark));
+
+// Shooter.Bench.Swarm [Units=10000] [Steps=600]
+// Headless, steps a swarm simulation at 60 Hz without a world and reports simulated units per millisecond
+static void RunSwarmBenchmark(const TArray<FString>& Args)
+{
+	const int32 NumUnits = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10'000;
+	const int32 NumSteps = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 600;
+
+	FDroneSwarmSimulation Simulation;
+	FRandomStream Random(1234);
+	for (int32 Unit = 0; Unit < NumUnits; ++Unit)
+	{
+		Simulation.AddUnit(Random.VRand() * Random.FRandRange(0.f, 5'000.f), Random.VRand() * Random.FRandRange(0.f, 5'000.f));
+	}
+	// A few players standing in the patrol area
+	for (int32 Hostile = 0; Hostile < 4; ++Hostile)
+	{
+		Simulation.HostileLocations.Add(Random.VRand() * Random.FRandRange(0.f, 5'000.f));
+	}
+
+	int64 TotalShots = 0;
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		Simulation.Step(1.f / 60.f);
+		TotalShots += Simulation.ShotsFiredLastStep;
+	}
+	const double TotalMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	UE_LOG(LogShooter, Display, TEXT("Benchmark Swarm: %d units, %d steps in %.2f ms, %.3f ms per step, %.0f units per ms, %lld shots"),
+		NumUnits,
+		NumSteps,
+		TotalMs,
+		TotalMs / FMath::Max(NumSteps, 1),
+		(static_cast<double>(NumUnits) * NumSteps) / FMath::Max(TotalMs, 0.001),
+		TotalShots);
+}
+
+static FAutoConsoleCommandWithArgs SwarmBenchmarkCommand(
+	TEXT("Shooter.Bench.Swarm"),
+	TEXT("Headless drone swarm simulation throughput. Usage: Shooter.Bench.Swarm [Units=10000] [Steps=600]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunSwarmBenchmark));
+
+// Shooter.Bench.Trace [Traces=10000]
+// Same random rays from the player's view traced against Visibility with complex collision and against the weapon channel with simple collision
+static void RunTraceBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	const int32 NumTraces = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10'000;
+
+	APlayerController* PlayerController = World ? UGameplayStatics::GetPlayerController(World, 0) : nullptr;
+	if (PlayerController == nullptr)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Shooter.Bench.Trace needs a local player"));
+		return;
+	}
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	TArray<FVector> Directions;
+	Directions.Reserve(NumTraces);
+	FRandomStream Random(1234);
+	for (int32 Trace = 0; Trace < NumTraces; ++Trace)
+	{
+		Directions.Add(Random.VRandCone(ViewRotation.Vector(), FMath::DegreesToRadians(30.f)));
+	}
+
+	auto RunTraces = [&](ECollisionChannel Channel, bool bTraceComplex, const TCHAR* Name)
+	{
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterTraceBenchmark), bTraceComplex, PlayerController->GetPawn());
+		int32 NumHits = 0;
+		const double StartTime = FPlatformTime::Seconds();
+		for (const FVector& Direction : Directions)
+		{
+			FHitResult Hit;
+			if (World->LineTraceSingleByChannel(Hit, ViewLocation, ViewLocation + Direction * 50'000.f, Channel, QueryParams))
+			{
+				++NumHits;
+			}
+		}
+		const double TotalMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		UE_LOG(LogShooter, Display, TEXT("Benchmark Trace [%s]: %d traces in %.2f ms, %.2f us per trace, %d hits"),
+			Name, NumTraces, TotalMs, TotalMs * 1000.0 / FMath::Max(NumTraces, 1), NumHits);
+	};
+
+	RunTraces(ECollisionChannel::ECC_Visibility, true, TEXT("Visibility complex"));
+	RunTraces(COLLISION_WEAPON, false, TEXT("Weapon simple"));
+}
+
+static FAutoConsoleCommandWithWorldAndArgs TraceBenchmarkCommand(
+	TEXT("Shooter.Bench.Trace"),
+	TEXT("Compares weapon trace cost of Visibility/complex and the weapon channel. Usage: Shooter.Bench.Trace [Traces=10000]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunTraceBenchmark));
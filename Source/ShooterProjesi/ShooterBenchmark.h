@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "ShooterAllocationTracker.h"
+
+class UWorld;
+
+// One measured phase of a frame benchmark
+struct FShooterBenchmarkPhase
+{
+	FString Name;
+
+	// Called once before the first measured frame of the phase
+	TFunction<void(UWorld*)> Begin;
+
+	// Called every frame of the phase with the frame index
+	TFunction<void(UWorld*, int32)> Frame;
+
+	// Called once after the last frame of the phase
+	TFunction<void(UWorld*)> End;
+};
+
+/*
+	Runs a list of phases over real engine frames and logs the average frame and game thread time of each phase,
+	and the per action allocations of the measured frames when Shooter.Allocs.Enabled is set.
+	Used by the Shooter.Bench.* console commands to compare two implementations of the same gameplay feature
+	in the same level with the same pawn count.
+*/
+class SHOOTERPROJESI_API FShooterFrameBenchmark : public TSharedFromThis<FShooterFrameBenchmark>
+{
+public:
+	FShooterFrameBenchmark(const FString& InName, UWorld* InWorld, int32 InFramesPerPhase, int32 InWarmupFrames = 30);
+
+	void AddPhase(const FShooterBenchmarkPhase& Phase);
+
+	// Starts ticking, keeps itself alive until every phase has finished
+	void Run();
+
+private:
+	bool Tick(float DeltaTime);
+
+	void LogPhaseResult() const;
+
+	FString Name;
+
+	TWeakObjectPtr<UWorld> World;
+
+	TArray<FShooterBenchmarkPhase> Phases;
+
+	int32 FramesPerPhase;
+
+	// Frames run after Begin before measuring, lets spawned actors settle
+	int32 WarmupFrames;
+
+	int32 PhaseIndex;
+
+	int32 PhaseFrame;
+
+	double TotalFrameMs;
+
+	double TotalGameThreadMs;
+
+	double MaxGameThreadMs;
+
+	// Allocation stats when measuring started
+	TMap<FName, FShooterActionAllocationStats> AllocationBaseline;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	// Keeps the benchmark alive while it is registered with the ticker
+	TSharedPtr<FShooterFrameBenchmark> SelfReference;
+};
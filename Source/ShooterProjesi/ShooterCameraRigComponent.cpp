@@ -0,0 +1,219 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterCameraRigComponent.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "Camera/CameraComponent.h"
+#include "Kismet/KismetMathLibrary.h"
+
+// Sets default values for this component's properties
+UShooterCameraRigComponent::UShooterCameraRigComponent()
+{
+	// Rig only ticks while a channel is interpolating
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	SpringArm = nullptr;
+	Camera = nullptr;
+
+	TargetFOV = 90.f;
+	FOVInterpSpeed = 0.f;
+	bFOVConverged = true;
+
+	TargetSocketOffset = FVector::ZeroVector;
+	SocketOffsetInterpSpeed = 0.f;
+	bSocketOffsetConverged = true;
+
+	TargetArmRotation = FRotator::ZeroRotator;
+	ArmRotationInterpSpeed = 0.f;
+	bArmRotationConverged = true;
+
+	CameraFocusInterpSpeed = 0.f;
+	bCameraFocusConverged = true;
+
+	AngleTolerance = 0.01f;
+	OffsetTolerance = 0.1f;
+}
+
+void UShooterCameraRigComponent::SetupRig(USpringArmComponent* InSpringArm, UCameraComponent* InCamera)
+{
+	SpringArm = InSpringArm;
+	Camera = InCamera;
+
+	// Start converged on whatever the components currently hold
+	if (Camera)
+	{
+		TargetFOV = Camera->FieldOfView;
+	}
+	if (SpringArm)
+	{
+		TargetSocketOffset = SpringArm->SocketOffset;
+		TargetArmRotation = SpringArm->GetComponentRotation();
+	}
+}
+
+void UShooterCameraRigComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	WakeIfNeeded();
+}
+
+void UShooterCameraRigComponent::SetTargetFOV(float InTargetFOV, float InterpSpeed)
+{
+	// Target is always kept, a press and release before the next tick must end on the release's target
+	TargetFOV = InTargetFOV;
+	FOVInterpSpeed = InterpSpeed;
+	if (Camera == nullptr || FMath::IsNearlyEqual(Camera->FieldOfView, InTargetFOV, AngleTolerance))
+	{
+		// Nothing to interpolate, don't wake the rig
+		bFOVConverged = true;
+		return;
+	}
+	bFOVConverged = false;
+	WakeIfNeeded();
+}
+
+void UShooterCameraRigComponent::SetTargetSocketOffset(const FVector& InTargetOffset, float InterpSpeed)
+{
+	TargetSocketOffset = InTargetOffset;
+	SocketOffsetInterpSpeed = InterpSpeed;
+	if (SpringArm == nullptr || SpringArm->SocketOffset.Equals(InTargetOffset, OffsetTolerance))
+	{
+		bSocketOffsetConverged = true;
+		return;
+	}
+	bSocketOffsetConverged = false;
+	WakeIfNeeded();
+}
+
+void UShooterCameraRigComponent::SetTargetArmRotation(const FRotator& InTargetRotation, float InterpSpeed)
+{
+	TargetArmRotation = InTargetRotation;
+	ArmRotationInterpSpeed = InterpSpeed;
+	if (SpringArm == nullptr || SpringArm->GetComponentRotation().Equals(InTargetRotation, AngleTolerance))
+	{
+		bArmRotationConverged = true;
+		return;
+	}
+	bArmRotationConverged = false;
+	WakeIfNeeded();
+}
+
+void UShooterCameraRigComponent::SetCameraFocusOnOwner(float InterpSpeed)
+{
+	CameraFocusInterpSpeed = InterpSpeed;
+	if (Camera == nullptr || GetOwner() == nullptr || InterpSpeed <= 0.f)
+	{
+		bCameraFocusConverged = true;
+		return;
+	}
+	// Owner or camera may have moved since the last check
+	const FRotator LookAtRotation = UKismetMathLibrary::FindLookAtRotation(Camera->GetComponentLocation(), GetOwner()->GetActorLocation());
+	if (!Camera->GetComponentRotation().Equals(LookAtRotation, AngleTolerance))
+	{
+		bCameraFocusConverged = false;
+		WakeIfNeeded();
+	}
+}
+
+bool UShooterCameraRigComponent::IsConverged() const
+{
+	return bFOVConverged && bSocketOffsetConverged && bArmRotationConverged && bCameraFocusConverged;
+}
+
+void UShooterCameraRigComponent::WakeIfNeeded()
+{
+	if (!IsConverged() && !IsComponentTickEnabled())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+bool UShooterCameraRigComponent::UpdateFOV(float DeltaTime)
+{
+	if (bFOVConverged)
+	{
+		return true;
+	}
+	float FOV = FMath::FInterpTo(Camera->FieldOfView, TargetFOV, DeltaTime, FOVInterpSpeed);
+	if (FMath::IsNearlyEqual(FOV, TargetFOV, AngleTolerance))
+	{
+		FOV = TargetFOV;
+		bFOVConverged = true;
+	}
+	Camera->SetFieldOfView(FOV);
+	return bFOVConverged;
+}
+
+bool UShooterCameraRigComponent::UpdateSocketOffset(float DeltaTime)
+{
+	if (bSocketOffsetConverged)
+	{
+		return true;
+	}
+	FVector Offset = FMath::VInterpTo(SpringArm->SocketOffset, TargetSocketOffset, DeltaTime, SocketOffsetInterpSpeed);
+	if (Offset.Equals(TargetSocketOffset, OffsetTolerance))
+	{
+		Offset = TargetSocketOffset;
+		bSocketOffsetConverged = true;
+	}
+	SpringArm->SocketOffset = Offset;
+	return bSocketOffsetConverged;
+}
+
+bool UShooterCameraRigComponent::UpdateArmRotation(float DeltaTime)
+{
+	if (bArmRotationConverged)
+	{
+		return true;
+	}
+	FRotator Rotation = UKismetMathLibrary::RInterpTo(SpringArm->GetComponentRotation(), TargetArmRotation, DeltaTime, ArmRotationInterpSpeed);
+	if (Rotation.Equals(TargetArmRotation, AngleTolerance))
+	{
+		Rotation = TargetArmRotation;
+		bArmRotationConverged = true;
+	}
+	SpringArm->SetWorldRotation(Rotation);
+	return bArmRotationConverged;
+}
+
+bool UShooterCameraRigComponent::UpdateCameraFocus(float DeltaTime)
+{
+	if (bCameraFocusConverged)
+	{
+		return true;
+	}
+	const FRotator LookAtRotation = UKismetMathLibrary::FindLookAtRotation(Camera->GetComponentLocation(), GetOwner()->GetActorLocation());
+	FRotator Rotation = UKismetMathLibrary::RInterpTo(Camera->GetComponentRotation(), LookAtRotation, DeltaTime, CameraFocusInterpSpeed);
+	if (Rotation.Equals(LookAtRotation, AngleTolerance))
+	{
+		Rotation = LookAtRotation;
+		bCameraFocusConverged = true;
+	}
+	Camera->SetWorldRotation(Rotation);
+	return bCameraFocusConverged;
+}
+
+void UShooterCameraRigComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (SpringArm == nullptr || Camera == nullptr)
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	// Evaluate every channel, arm first so the camera focus sees the new camera location
+	bool bConverged = UpdateArmRotation(DeltaTime);
+	bConverged &= UpdateSocketOffset(DeltaTime);
+	bConverged &= UpdateFOV(DeltaTime);
+	bConverged &= UpdateCameraFocus(DeltaTime);
+
+	if (bConverged)
+	{
+		// Idle until a new target is set
+		SetComponentTickEnabled(false);
+	}
+}
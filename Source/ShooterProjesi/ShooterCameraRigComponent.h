@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ShooterCameraRigComponent.generated.h"
+
+/*
+	Drives a spring arm + camera pair towards interpolated targets (FOV, socket offset, arm rotation, camera focus).
+	Writes to the camera/spring arm are skipped once a channel has converged and the component stops ticking
+	entirely when every channel is idle. Setting a new target wakes it up again.
+*/
+UCLASS(ClassGroup = (Camera), meta = (BlueprintSpawnableComponent))
+class SHOOTERPROJESI_API UShooterCameraRigComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UShooterCameraRigComponent();
+
+	// Spring arm and camera this rig writes to. Must be called before any target is set
+	void SetupRig(class USpringArmComponent* InSpringArm, class UCameraComponent* InCamera);
+
+	// Interpolate camera field of view to TargetFOV
+	void SetTargetFOV(float TargetFOV, float InterpSpeed);
+
+	// Interpolate spring arm socket offset to TargetOffset (shoulder switch)
+	void SetTargetSocketOffset(const FVector& TargetOffset, float InterpSpeed);
+
+	// Interpolate spring arm world rotation to TargetRotation
+	void SetTargetArmRotation(const FRotator& TargetRotation, float InterpSpeed);
+
+	// Rotate camera to look at owner's location, 0 speed disables the focus
+	void SetCameraFocusOnOwner(float InterpSpeed);
+
+	// Returns the rotation the arm is interpolating to
+	FORCEINLINE FRotator GetTargetArmRotation() const { return TargetArmRotation; }
+
+	// True when every channel reached its target
+	bool IsConverged() const;
+
+protected:
+	virtual void BeginPlay() override;
+
+public:
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	// Enables tick if any channel still has work to do
+	void WakeIfNeeded();
+
+	bool UpdateFOV(float DeltaTime);
+	bool UpdateSocketOffset(float DeltaTime);
+	bool UpdateArmRotation(float DeltaTime);
+	bool UpdateCameraFocus(float DeltaTime);
+
+	UPROPERTY()
+	USpringArmComponent* SpringArm;
+
+	UPROPERTY()
+	UCameraComponent* Camera;
+
+	float TargetFOV;
+	float FOVInterpSpeed;
+	bool bFOVConverged;
+
+	FVector TargetSocketOffset;
+	float SocketOffsetInterpSpeed;
+	bool bSocketOffsetConverged;
+
+	FRotator TargetArmRotation;
+	float ArmRotationInterpSpeed;
+	bool bArmRotationConverged;
+
+	float CameraFocusInterpSpeed;
+	bool bCameraFocusConverged;
+
+	// Difference in degrees below which FOV and rotations are snapped to target
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Rig", meta = (AllowPrivateAccess = "true"))
+	float AngleTolerance;
+
+	// Difference in units below which socket offset is snapped to target
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Rig", meta = (AllowPrivateAccess = "true"))
+	float OffsetTolerance;
+};
@@ -1,589 +1,1238 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "ShooterCharacter.h"
-#include "GameFramework/SpringArmComponent.h"
-#include "Camera/CameraComponent.h"
-#include "GameFramework/CharacterMovementComponent.h"
-#include "Kismet/GameplayStatics.h"
-#include "Sound/SoundCue.h"
-#include "Engine/SkeletalMeshSocket.h"
-#include "DrawDebugHelpers.h"
-#include "Particles/ParticleSystemComponent.h"
-#include "Drone.h"
-#include "TimerManager.h"
-
-// Sets default values
-AShooterCharacter::AShooterCharacter()
-	
-{
- 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
-	
-	// Initialize Camera Y offset value. This must be initialized before Camera->SocketOffset!
-	CameraYOffset = 50.f;
-
-	//Create a camera boom (pulls in towards the character if there is a collision)
-	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
-	CameraBoom->SetupAttachment(RootComponent);
-	CameraBoom->TargetArmLength = 250.f; // the camera follows at the distance behind the character
-	CameraBoom->bUsePawnControlRotation = true; // rotate the arm based on the controller
-	CameraBoom->SocketOffset = FVector(0.f, CameraYOffset, 70.f);
-	
-	FollowCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
-	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach camera to end of the boom
-	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
-
-	// Preventing the character to rotate when controller rotates.
-	bUseControllerRotationPitch = false;
-	bUseControllerRotationYaw = true;
-	bUseControllerRotationYaw = false;
-
-	GetCharacterMovement()->bOrientRotationToMovement = false; // Character moves in direction of input...
-	GetCharacterMovement()->RotationRate = FRotator(0.f, 540.f, 0.f); // ...with this rotation rate
-
-	GetCharacterMovement()->JumpZVelocity = 600.f;
-	GetCharacterMovement()->AirControl = 0.3f;
-
-	//Initialize turn rate and look up
-	BaseTurnRate = 45.f;
-	BaseLookUpRate = 45.f;
-
-	// Turn rates for aiming/not aiming 
-	HipTurnRate = 90.f;
-	HipLookUpRate = 90.f;
-	AimingTurnRate = 20.f;
-	AimingLookUpRate = 20.f;
-
-	// Mouse sensivity scale factors
-	MouseHipTurnRate = 1.f;
-	MouseHipLookUpRate = 1.f;
-	MouseAimingTurnRate = .2f;
-	MouseAimingLookUpRate = .2f;
-
-	// Initialize Camera settings
-	bAiming = false;
-	CameraDefaultFOV = 0.f;
-	CameraZoomedFOV = 50.f;
-	ZoomInterpSpeed = 20.f;
-
-	//Dash
-	ForceMultiplier = 6.5f;
-	bIsDashActive = false;
-	DashCooldown = 3.0f;
-
-	// Crosshair spread factors
-	CrosshairSpreadMultiplier = 0.f;
-	CrosshairVelocityFactor = 0.f;
-	CrosshairInAirFactor = 0.f;
-	CrosshairAimFactor = 0.f;
-	CrosshairShootingFactor = 0.f;
-
-	// Bullet fire timer variables
-	ShootTimeDuraiton = 0.05f;
-	bFiringBullet = false;
-
-	// Auto rifle fire variables
-	AutomaticFireRate = 0.1f;
-	bFireButtonPressed = false;
-	bShouldFire = true;
-	bSwitchToAuto = false; // Switch between firing modes
-
-	bSlowMoActive = false;
-
-	// Drone control duration
-	DroneTime = 3.f;
-
-
-}
-
-// Called when the game starts or when spawned
-void AShooterCharacter::BeginPlay()
-{
-	Super::BeginPlay();
-
-	if (FollowCamera)
-	{
-		CameraDefaultFOV = GetFollowCamera()->FieldOfView;
-		CameraCurrentFOV = CameraDefaultFOV;
-	}
-	
-}
-
-void AShooterCharacter::MoveForward(float Value)
-{
-	if ((Controller != nullptr) && (Value != 0.0f))
-	{	
-		// Find out which way is forward
-		const FRotator Rotation{ Controller->GetControlRotation() };
-		const FRotator YawRotation{ 0, Rotation.Yaw, 0 };
-		const FVector Direction{ FRotationMatrix{YawRotation}.GetUnitAxis(EAxis::X) };
-		AddMovementInput(Direction, Value);
-	}
-}
-
-void AShooterCharacter::MoveRight(float Value)
-{
-	if ((Controller != nullptr) && (Value != 0.0f))
-	{
-		const FRotator Rotation{ Controller->GetControlRotation() };
-		const FRotator YawRotation{ 0,Rotation.Yaw,0 };
-		const FVector Direction{ FRotationMatrix{YawRotation}.GetUnitAxis(EAxis::Y) };
-		AddMovementInput(Direction, Value);
-	}
-}
-
-void AShooterCharacter::LookUpAtRate(float Rate)
-{
-	AddControllerPitchInput(Rate * BaseLookUpRate * GetWorld()->GetDeltaSeconds()); //BaseLookUpRate = degree/second, DeltaTime = second/frame
-
-}
-
-
-void AShooterCharacter::TurnAtRate(float Rate)
-{
-	AddControllerYawInput(Rate * BaseTurnRate * GetWorld()->GetDeltaSeconds()); //BaseTurnRate = degree/second, DeltaTime = second/frame
-}
-
-void AShooterCharacter::Turn(float Value)
-{
-	float TurnScaleFactor = 0.f;
-	if (bAiming)
-	{
-		TurnScaleFactor = MouseAimingTurnRate;
-	}
-	else
-	{
-		TurnScaleFactor = MouseHipTurnRate;
-	}
-	AddControllerYawInput(Value * TurnScaleFactor); 
-}
-
-void AShooterCharacter::LookUp(float Value)
-{
-	float LookUpScaelFactor = 0.f;
-	if (bAiming)
-	{
-		LookUpScaelFactor = MouseAimingLookUpRate;
-	}
-	else
-	{
-		LookUpScaelFactor = MouseHipLookUpRate;
-	}
-	AddControllerPitchInput(Value * LookUpScaelFactor);
-}
-
-void AShooterCharacter::FireWeapon()
-{
-	if (FireSound)
-	{
-		UGameplayStatics::PlaySound2D(this, FireSound);
-	}
-	const USkeletalMeshSocket* BarrelSocket = GetMesh()->GetSocketByName("BarrelSocket");
-	if (BarrelSocket)
-	{
-		const FTransform SocketTransform = BarrelSocket->GetSocketTransform(GetMesh());
-		if (MuzzleFlash)
-		{
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlash, SocketTransform);
-		}
-
-		FVector BeamEnd;
-		bool bBeamEnd = GetBeamEndLocation(SocketTransform.GetLocation(), BeamEnd);
-
-		if (bBeamEnd)
-		{
-			// Spawn impact particles after updating BeamEndPoint
-			if (ImpactParticle)
-			{
-				UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticle, BeamEnd);
-			}
-
-			if (BeamParticles)
-			{
-				UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BeamParticles, SocketTransform);
-				if (Beam)
-				{
-					Beam->SetVectorParameter(FName("Target"), BeamEnd);
-				}
-
-			}
-		}
-
-	}
-	// Recoil Animation 
-	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-	if (AnimInstance && HipFireMontage)
-	{
-		AnimInstance->Montage_Play(HipFireMontage);
-		AnimInstance->Montage_JumpToSection(FName("StartFire")); 
-	}
-	// Start bullet fire timer for crosshairs
-	StartCrosshairBulletFire();
-	 
-}
-
-bool AShooterCharacter::GetBeamEndLocation(const FVector& MuzzleSocketLocation, FVector& OutBeamLocation)
-{
-	// Get Viewport Size
-	FVector2D ViewportSize;
-	if (GEngine && GEngine->GameViewport)
-	{
-		GEngine->GameViewport->GetViewportSize(ViewportSize);
-	}
-	
-	// Get screen space of crosshairs
-	FVector2D CrosshairLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
-
-	FVector CrosshairWorldPosition;
-	FVector CrosshairWorldDirection;
-
-
-	// Get world position and direction of crosshairs
-	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0), CrosshairLocation,
-		CrosshairWorldPosition,
-		CrosshairWorldDirection);
-
-	if (bScreenToWorld) // was deprojection succesfull?
-	{
-		FHitResult ScreenTraceHit;
-		const FVector Start = CrosshairWorldPosition;
-		const FVector End = Start + CrosshairWorldDirection * 50'000.f;
-
-		// Set beam end point to line trace end point
-		OutBeamLocation = End;
-
-		// Trace outward from crosshairs world location
-		GetWorld()->LineTraceSingleByChannel(ScreenTraceHit, Start, End, ECollisionChannel::ECC_Visibility);
-
-		if (ScreenTraceHit.bBlockingHit) // did trace hit?
-		{
-			// Beam end point is now trace hit location
-			OutBeamLocation = ScreenTraceHit.Location;
-			
-			// This is for the testing, damage system is not complete
-			UGameplayStatics::ApplyDamage(ScreenTraceHit.GetActor(), 1.f, nullptr, nullptr, nullptr);
-
-
-			// Second trace from gun barrel
-			FHitResult WeaponTraceHit;
-			const FVector WeaponTraceStart = MuzzleSocketLocation;
-			const FVector WeaponTraceEnd = OutBeamLocation;
-			GetWorld()->LineTraceSingleByChannel(WeaponTraceHit, WeaponTraceStart, WeaponTraceEnd, ECollisionChannel::ECC_Visibility);
-
-			if (WeaponTraceHit.bBlockingHit)
-			{																							
-				OutBeamLocation = WeaponTraceHit.Location;
-			}
-			return true;
-		}
-	}
-	return false;
-}
-
-void AShooterCharacter::AimingButtonPressed()
-{
-	bAiming = true;
-}
-
-void AShooterCharacter::AimingButtonReleased()
-{
-	bAiming = false;
-}
-
-void AShooterCharacter::CameraInterpZoom(float Deltatime)
-{
-	if (bAiming)
-	{
-		CameraCurrentFOV = FMath::FInterpTo(CameraCurrentFOV, CameraZoomedFOV, Deltatime, ZoomInterpSpeed);
-	}
-	else
-	{
-		CameraCurrentFOV = FMath::FInterpTo(CameraCurrentFOV, CameraDefaultFOV, Deltatime, ZoomInterpSpeed);
-	}
-	GetFollowCamera()->SetFieldOfView(CameraCurrentFOV);
-}
-
-void AShooterCharacter::SetLookRates()
-{
-	if (bAiming)
-	{
-		BaseTurnRate = AimingTurnRate;
-		BaseLookUpRate = AimingLookUpRate;
-	}
-	else
-	{
-		BaseTurnRate = HipTurnRate;
-		BaseLookUpRate = HipLookUpRate;
-	}
-}
-
-// Dash ability 
-// This can be re-done with using Apply Root Motion Constant Force function in Unreal's Game Ability System
-void AShooterCharacter::DashAbility()
-{
-	if (!bIsDashActive)
-	{
-			if(GetVelocity().Normalize()) // if character has velocity 
-			{
-				
-				if (!GetCharacterMovement()->IsFalling())
-				{
-					bIsDashActive = true;
-					if (DashSound)
-					{
-						UGameplayStatics::PlaySound2D(this, DashSound);
-					}
-					
-					FVector LaunchVelocity = this->GetVelocity() * ForceMultiplier;
-					LaunchCharacter(LaunchVelocity, true, false);
-					GetMovementComponent()->StopMovementKeepPathing();
-					GetWorldTimerManager().SetTimer(DashTimer, this, &AShooterCharacter::SetDashActiveToFalse, DashCooldown); //Ability cooldown
-				}
-			}
-			
-	}
-}
-
-// Set bIsDashActive for cooldown timer
-void AShooterCharacter::SetDashActiveToFalse()
-{
-	bIsDashActive= false;
-}
-
-// Calculate Cross hair spread based on character's movement
-void AShooterCharacter::CalculateCrossHairSpread(float DeltaTime)
-{
-	FVector2D WalkSpeedRange = FVector2D(0.f, 600.f);
-	FVector2D VelocityMultiplierRange = FVector2D(0.f, 1.f);
-	FVector Velocity = GetVelocity();
-	Velocity.Z = 0.f;
-
-	CrosshairVelocityFactor = FMath::GetMappedRangeValueClamped(WalkSpeedRange, VelocityMultiplierRange, Velocity.Size());
-	if (GetCharacterMovement()->IsFalling()) // Is character in air?
-	{
-		// Spread crosshair slowly while in the air
-		CrosshairInAirFactor = FMath::FInterpTo(CrosshairInAirFactor, 2.25f, DeltaTime, 2.25f);
-	}
-	else 
-	{
-		// Shrink the croshair rapidly while on the ground
-		CrosshairInAirFactor = FMath::FInterpTo(CrosshairInAirFactor, 0.f, DeltaTime, 30.f);
-	}
-	if (bAiming) // Is Character aiming?
-	{
-		CrosshairAimFactor = FMath::FInterpTo(CrosshairAimFactor, 0.5f, DeltaTime, 20.f);
-	}
-	else // Character is not aiming
-	{
-		CrosshairAimFactor = FMath::FInterpTo(CrosshairAimFactor, 0.f, DeltaTime, 20.f);
-	}
-	// true 0.05 second after firing
-	if (bFiringBullet)
-	{
-		CrosshairShootingFactor = FMath::FInterpTo(CrosshairShootingFactor, 0.3f, DeltaTime, 60.f);
-	}
-	else
-	{
-		CrosshairShootingFactor = FMath::FInterpTo(CrosshairShootingFactor, 0.f, DeltaTime, 60.f);
-	}
-
-	CrosshairSpreadMultiplier = 0.5f + CrosshairVelocityFactor + CrosshairInAirFactor - CrosshairAimFactor + CrosshairShootingFactor;
-}
-
-void AShooterCharacter::StartCrosshairBulletFire()
-{
-	bFiringBullet = true;
-
-	GetWorldTimerManager().SetTimer(CrosshairShootTimer, this, &AShooterCharacter::FinishCrosshairBulletFire, ShootTimeDuraiton);
-}
-
-void AShooterCharacter::FinishCrosshairBulletFire()
-{
-	bFiringBullet = false;
-}
-
-void AShooterCharacter::FireButtonPressed()
-{
-	if (bSwitchToAuto)
-	{
-		bFireButtonPressed = true;
-		StartFireTimer();
-	}
-	else
-	{
-		FireWeapon();
-	}
-	
-}
-
-void AShooterCharacter::FireButtonReleased()
-{
-	bFireButtonPressed = false;
-}
-
-void AShooterCharacter::StartFireTimer()
-{
-	if (bShouldFire)
-	{
-		FireWeapon();
-		bShouldFire = false;
-		GetWorldTimerManager().SetTimer(AutoFireTimerHandle, this, &AShooterCharacter::AutoFireReset, AutomaticFireRate);
-	}
-
-}
-
-void AShooterCharacter::AutoFireReset()
-{
-	bShouldFire = true;
-	if (bFireButtonPressed)
-	{
-		StartFireTimer();
-	}
-
-}
-// Switch between full auto and singular shots
-void AShooterCharacter::SwitchBetweenShootingModes()
-{
-	if (bSwitchToAuto)
-	{
-		bSwitchToAuto = false;
-	}
-	else
-	{
-		bSwitchToAuto = true;
-	}
-
-	UGameplayStatics::PlaySound2D(this, SwitchModeSound);
-
-}
-
-
-//Switches camera shoulder
-void AShooterCharacter::SwitchCameraSides()
-{	
-	CameraYOffset *= -1.f;
-	CameraBoom->SocketOffset.Y = CameraYOffset;
-
-		
-}
-
-// Activate or deactive the slow motion
-void AShooterCharacter::SlowMotionAbility()
-{
-	if(!bSlowMoActive)
-	{
-		bSlowMoActive = true;
-		UGameplayStatics::PlaySound2D(this, SlowMoBeginSound);
-		UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 0.5f);
-	}
-	else
-	{
-		bSlowMoActive = false;
-		UGameplayStatics::PlaySound2D(this, SlowMoEndSound);
-		UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 1.f);
-
-	}
-
-}
-
-
-// Spawn and control drone
-void AShooterCharacter::DroneAbility()
-{
-	// If you possess the drone while character is in the air, character will be hang in air. This prevents that bug
-	if (!GetCharacterMovement()->IsFalling()) 
-	{
-	
-		FVector Location = FVector(GetActorLocation().X, GetActorLocation().Y + 50.f, GetActorLocation().Z + 200);
-		FTransform DroneTransform = GetActorTransform();
-		DroneTransform.SetLocation(Location); // Drone will spawn at top of the character
-
-		// Spawn the drone
-		MyDrone = GetWorld()->SpawnActorDeferred<ADrone>(Drone, DroneTransform, this, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
-		if (MyDrone)
-		{
-			MyDrone->FinishSpawning(DroneTransform);
-		}
-
-
-		// If you possess the drone while running character will stuck in that running animation. This prevents that bug
-		GetCharacterMovement()->StopMovementKeepPathing();
-
-		UGameplayStatics::GetPlayerController(GetWorld(), 0)->Possess(MyDrone); // Control the drone
-
-
-
-		// Drone control duration can be changed via DroneTime
-		GetWorldTimerManager().SetTimer(DroneTimerHandle, this, &AShooterCharacter::DroneToPlayer, DroneTime);
-		
-
-		// Needs a skill cooldown
-
-		// Needs a max range 
-
-	}
-	
-}
-
-
-void AShooterCharacter::DroneToPlayer()
-{
-	
-	UGameplayStatics::GetPlayerController(GetWorld(), 0)->Possess(this); // posses player back
-	
-	MyDrone->Destroy(); // Destroy the drone
-}
-
-float AShooterCharacter::GetCrosshairSpreadMultiplier() const
-{
-	return CrosshairSpreadMultiplier;
-}
-
-// Called every frame
-void AShooterCharacter::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-	CameraInterpZoom(DeltaTime);
-	SetLookRates();
-	CalculateCrossHairSpread(DeltaTime);
-
-				
-}
-
-// Called to bind functionality to input
-void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
-{
-	Super::SetupPlayerInputComponent(PlayerInputComponent);
-	
-	check(PlayerInputComponent);
-
-	PlayerInputComponent->BindAxis("MoveForward", this, &AShooterCharacter::MoveForward);
-	PlayerInputComponent->BindAxis("MoveRight", this, &AShooterCharacter::MoveRight);
-	PlayerInputComponent->BindAxis("TurnRate", this, &AShooterCharacter::TurnAtRate);
-	PlayerInputComponent->BindAxis("LookUpRate", this, &AShooterCharacter::LookUpAtRate);
-	PlayerInputComponent->BindAxis("Turn", this, &AShooterCharacter::Turn);
-	PlayerInputComponent->BindAxis("LookUp", this, &AShooterCharacter::LookUp);
-
-	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &ACharacter::Jump);
-	PlayerInputComponent->BindAction("Jump", IE_Released, this, &ACharacter::StopJumping);
-
-	PlayerInputComponent->BindAction("FireButton", IE_Pressed, this, &AShooterCharacter::FireButtonPressed);
-	PlayerInputComponent->BindAction("FireButton", IE_Released, this, &AShooterCharacter::FireButtonReleased);
-
-	PlayerInputComponent->BindAction("AimingButton", IE_Pressed, this, &AShooterCharacter::AimingButtonPressed);
-	PlayerInputComponent->BindAction("AimingButton", IE_Released, this, &AShooterCharacter::AimingButtonReleased);
-
-	PlayerInputComponent->BindAction("Dash", IE_Pressed, this, &AShooterCharacter::DashAbility);
-	
-	PlayerInputComponent->BindAction("SwitchBetweenWeaponModes", IE_Pressed, this, &AShooterCharacter::SwitchBetweenShootingModes);
-
-	PlayerInputComponent->BindAction("SwitchCameraSides", IE_Pressed, this, &AShooterCharacter::SwitchCameraSides);
-
-	PlayerInputComponent->BindAction("SlowMotion", IE_Pressed, this, &AShooterCharacter::SlowMotionAbility);
-
-	PlayerInputComponent->BindAction("DroneAbility", IE_Pressed, this, &AShooterCharacter::DroneAbility);
-
-	
-
-}
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterCharacter.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "Camera/CameraComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundCue.h"
+#include "Engine/SkeletalMeshSocket.h"
+#include "DrawDebugHelpers.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Drone.h"
+#include "ShooterCameraRigComponent.h"
+#include "ShooterCooldownComponent.h"
+#include "ShooterShotLatency.h"
+#include "ShooterShotBatch.h"
+#include "ShooterHUD.h"
+#include "Item.h"
+#include "ShooterTaskScheduler.h"
+#include "ShooterFixedStep.h"
+#include "ShooterHitchDetector.h"
+#include "ShooterAllocationTracker.h"
+#include "ShooterImpactResponse.h"
+#include "ShooterProjesi.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/PlayerController.h"
+
+// Cooldown names on the character's cooldown component
+namespace ShooterCharacterCooldowns
+{
+	const FName Dash(TEXT("Dash"));
+	const FName ShotSpread(TEXT("ShotSpread"));
+	const FName AutoFire(TEXT("AutoFire"));
+	const FName DroneControl(TEXT("DroneControl"));
+}
+
+// Sets default values
+AShooterCharacter::AShooterCharacter()
+	
+{
+ 	// Crosshair spread and item focus run on the task scheduler, look rates change with aiming
+	PrimaryActorTick.bCanEverTick = false;
+	
+	// Initialize Camera Y offset value. This must be initialized before Camera->SocketOffset!
+	CameraYOffset = 50.f;
+
+	//Create a camera boom (pulls in towards the character if there is a collision)
+	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
+	CameraBoom->SetupAttachment(RootComponent);
+	CameraBoom->TargetArmLength = 250.f; // the camera follows at the distance behind the character
+	CameraBoom->bUsePawnControlRotation = true; // rotate the arm based on the controller
+	CameraBoom->SocketOffset = FVector(0.f, CameraYOffset, 70.f);
+	
+	FollowCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
+	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach camera to end of the boom
+	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
+
+	CameraRig = CreateDefaultSubobject<UShooterCameraRigComponent>(TEXT("CameraRig"));
+
+	Cooldowns = CreateDefaultSubobject<UShooterCooldownComponent>(TEXT("Cooldowns"));
+
+	// Preventing the character to rotate when controller rotates.
+	bUseControllerRotationPitch = false;
+	bUseControllerRotationYaw = true;
+	bUseControllerRotationYaw = false;
+
+	GetCharacterMovement()->bOrientRotationToMovement = false; // Character moves in direction of input...
+	GetCharacterMovement()->RotationRate = FRotator(0.f, 540.f, 0.f); // ...with this rotation rate
+
+	// Weapon traces pass through the capsule and hit the simple bodies of the physics asset
+	GetCapsuleComponent()->SetCollisionResponseToChannel(COLLISION_WEAPON, ECollisionResponse::ECR_Ignore);
+	GetMesh()->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	GetMesh()->SetCollisionResponseToChannel(COLLISION_WEAPON, ECollisionResponse::ECR_Block);
+
+	// Hitbox damage zones, bone names of the UE mannequin
+	BoneDamageMultipliers.Add(FName("head"), 4.f);
+	BoneDamageMultipliers.Add(FName("neck_01"), 2.f);
+	BoneDamageMultipliers.Add(FName("spine_03"), 1.2f);
+	WeaponDamage = 1.f;
+
+	GetCharacterMovement()->JumpZVelocity = 600.f;
+	GetCharacterMovement()->AirControl = 0.3f;
+
+	//Initialize turn rate and look up
+	BaseTurnRate = 45.f;
+	BaseLookUpRate = 45.f;
+
+	// Turn rates for aiming/not aiming 
+	HipTurnRate = 90.f;
+	HipLookUpRate = 90.f;
+	AimingTurnRate = 20.f;
+	AimingLookUpRate = 20.f;
+
+	// Mouse sensivity scale factors
+	MouseHipTurnRate = 1.f;
+	MouseHipLookUpRate = 1.f;
+	MouseAimingTurnRate = .2f;
+	MouseAimingLookUpRate = .2f;
+
+	// Initialize Camera settings
+	bAiming = false;
+	CameraDefaultFOV = 0.f;
+	CameraZoomedFOV = 50.f;
+	ZoomInterpSpeed = 20.f;
+	CameraSideInterpSpeed = 10.f;
+
+	//Dash
+	ForceMultiplier = 6.5f;
+	DashCooldown = 3.0f;
+
+	// Crosshair spread factors
+	CrosshairSpreadMultiplier = 0.f;
+	CrosshairSpreadChangeThreshold = 0.01f;
+	BroadcastCrosshairSpread = 0.f;
+	bClosedFormCrosshairSpread = true;
+	CrosshairTimeBase = 0.f;
+	CrosshairWorldTimeBase = 0.f;
+
+	ItemFocusRadius = 600.f;
+	ItemFocusAngle = 20.f;
+	ItemFocusInterval = 0.1f;
+
+	CrosshairSpreadTaskId = INDEX_NONE;
+	ItemFocusTaskId = INDEX_NONE;
+	LookRatesStepId = INDEX_NONE;
+	LookUpRateInput = 0.f;
+	TurnRateInput = 0.f;
+
+	MaxWeapons = 3;
+	WeaponHandSocketName = FName("RightHandSocket");
+	EquippedWeaponIndex = INDEX_NONE;
+	CrosshairVelocityFactor = 0.f;
+	CrosshairInAirFactor = 0.f;
+	CrosshairAimFactor = 0.f;
+	CrosshairShootingFactor = 0.f;
+
+	// Bullet fire timer variables
+	ShootTimeDuraiton = 0.05f;
+
+	// Auto rifle fire variables
+	AutomaticFireRate = 0.1f;
+	bFireButtonPressed = false;
+	FireMode = EShooterFireMode::EFM_Single;
+	PelletCount = 10;
+	PelletSpreadAngle = 4.f;
+	MaxPenetrations = 2;
+	PenetrationDepth = 50.f;
+	PenetrationDamageScale = 0.6f;
+
+	bSlowMoActive = false;
+	SlowMoScopeId = INDEX_NONE;
+	SlowMoRadius = 2'000.f;
+	SlowMoDilation = 0.5f;
+
+	// Drone control duration
+	DroneTime = 3.f;
+	bFastPawnSwitch = true;
+	DroneViewBlendTime = 0.25f;
+	bControllingDrone = false;
+	MyDrone = nullptr;
+
+	// Recoil
+	// Off until the anim blueprint derives from UShooterAnimInstance and applies the recoil layer
+	bUseProceduralRecoil = false;
+	ShotCounter = 0;
+
+
+}
+
+// Called when the game starts or when spawned
+void AShooterCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (FollowCamera)
+	{
+		CameraDefaultFOV = GetFollowCamera()->FieldOfView;
+	}
+	CameraRig->SetupRig(CameraBoom, FollowCamera);
+
+	// Resolved once, FireWeapon reads the bone transform directly
+	BarrelSocket.Resolve(GetMesh(), FName("BarrelSocket"));
+	SpawnWeaponPool();
+
+	SetLookRates();
+	RegisterScheduledTasks();
+	
+}
+
+void AShooterCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UShooterTaskSchedulerSubsystem* Scheduler = GetWorld()->GetSubsystem<UShooterTaskSchedulerSubsystem>())
+	{
+		Scheduler->UnregisterTask(CrosshairSpreadTaskId);
+		Scheduler->UnregisterTask(ItemFocusTaskId);
+	}
+	if (UShooterFixedStepSubsystem* FixedStep = GetWorld()->GetSubsystem<UShooterFixedStepSubsystem>())
+	{
+		FixedStep->UnregisterStep(LookRatesStepId);
+	}
+	CrosshairSpreadTaskId = INDEX_NONE;
+	ItemFocusTaskId = INDEX_NONE;
+	LookRatesStepId = INDEX_NONE;
+
+	// A parked or externally controlled drone belongs to this character
+	if (MyDrone && (MyDrone->IsParked() || MyDrone->GetExternalController()))
+	{
+		MyDrone->Destroy();
+	}
+	MyDrone = nullptr;
+	bControllingDrone = false;
+
+	// Stowed and equipped weapons go with the character, dropped ones stay in the world
+	for (AWeapon* Weapon : WeaponPool)
+	{
+		if (Weapon && Weapon->GetOwner() == this)
+		{
+			Weapon->Destroy();
+		}
+	}
+	WeaponPool.Reset();
+	EquippedWeaponIndex = INDEX_NONE;
+
+	if (bSlowMoActive)
+	{
+		if (UShooterTimeDilationSubsystem* TimeDilation = GetWorld()->GetSubsystem<UShooterTimeDilationSubsystem>())
+		{
+			TimeDilation->RemoveScope(SlowMoScopeId);
+		}
+		bSlowMoActive = false;
+		SlowMoScopeId = INDEX_NONE;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShooterCharacter::RegisterScheduledTasks()
+{
+	if (UShooterFixedStepSubsystem* FixedStep = GetWorld()->GetSubsystem<UShooterFixedStepSubsystem>())
+	{
+		LookRatesStepId = FixedStep->RegisterStep(FName("LookRates"),
+			FShooterFixedStepDelegate::CreateUObject(this, &AShooterCharacter::SimulateLookRates), this);
+	}
+
+	UShooterTaskSchedulerSubsystem* Scheduler = GetWorld()->GetSubsystem<UShooterTaskSchedulerSubsystem>();
+	if (Scheduler == nullptr)
+	{
+		return;
+	}
+
+	UpdateCrosshairSpreadTask();
+
+	ItemFocusTaskId = Scheduler->RegisterTask(FName("ItemFocus"), EShooterTaskPriority::Low, 1.f / FMath::Max(ItemFocusInterval, 0.01f),
+		FShooterScheduledTaskDelegate::CreateUObject(this, &AShooterCharacter::UpdateFocusedItems), this);
+}
+
+void AShooterCharacter::UpdateCrosshairSpreadTask()
+{
+	UShooterTaskSchedulerSubsystem* Scheduler = GetWorld()->GetSubsystem<UShooterTaskSchedulerSubsystem>();
+	if (Scheduler == nullptr || !HasActorBegunPlay())
+	{
+		return;
+	}
+
+	// Closed form spread is evaluated on demand, only the local HUD needs to hear about every change
+	const bool bNeedsTask = !bClosedFormCrosshairSpread || IsLocallyControlled();
+	if (bNeedsTask && CrosshairSpreadTaskId == INDEX_NONE)
+	{
+		// Crosshair drives the HUD every frame, it is only deferred when the frame is over budget
+		CrosshairSpreadTaskId = Scheduler->RegisterTask(FName("CrosshairSpread"), EShooterTaskPriority::High, 0.f,
+			FShooterScheduledTaskDelegate::CreateUObject(this, &AShooterCharacter::CalculateCrossHairSpread), this);
+	}
+	else if (!bNeedsTask && CrosshairSpreadTaskId != INDEX_NONE)
+	{
+		Scheduler->UnregisterTask(CrosshairSpreadTaskId);
+		CrosshairSpreadTaskId = INDEX_NONE;
+	}
+}
+
+void AShooterCharacter::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+
+	UpdateCrosshairSpreadTask();
+}
+
+void AShooterCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PrevMovementMode, PreviousCustomMode);
+
+	const bool bFalling = GetCharacterMovement()->IsFalling();
+	if (bFalling != (PrevMovementMode == MOVE_Falling))
+	{
+		// Spread slowly while in the air, shrink rapidly on the ground
+		InAirSpread.SetTarget(GetCrosshairTime(), bFalling ? 2.25f : 0.f, bFalling ? 2.25f : 30.f);
+	}
+}
+
+void AShooterCharacter::MoveForward(float Value)
+{
+	if ((Controller != nullptr) && (Value != 0.0f))
+	{	
+		// Find out which way is forward
+		const FRotator Rotation{ Controller->GetControlRotation() };
+		const FRotator YawRotation{ 0, Rotation.Yaw, 0 };
+		const FVector Direction{ FRotationMatrix{YawRotation}.GetUnitAxis(EAxis::X) };
+		AddMovementInput(Direction, Value);
+	}
+}
+
+void AShooterCharacter::MoveRight(float Value)
+{
+	if ((Controller != nullptr) && (Value != 0.0f))
+	{
+		const FRotator Rotation{ Controller->GetControlRotation() };
+		const FRotator YawRotation{ 0,Rotation.Yaw,0 };
+		const FVector Direction{ FRotationMatrix{YawRotation}.GetUnitAxis(EAxis::Y) };
+		AddMovementInput(Direction, Value);
+	}
+}
+
+void AShooterCharacter::LookUpAtRate(float Rate)
+{
+	LookUpRateInput = Rate;
+}
+
+
+void AShooterCharacter::TurnAtRate(float Rate)
+{
+	TurnRateInput = Rate;
+}
+
+void AShooterCharacter::SimulateLookRates(float StepTime)
+{
+	if (LookUpRateInput != 0.f)
+	{
+		AddControllerPitchInput(LookUpRateInput * BaseLookUpRate * StepTime); //BaseLookUpRate = degree/second, StepTime = second/step
+	}
+	if (TurnRateInput != 0.f)
+	{
+		AddControllerYawInput(TurnRateInput * BaseTurnRate * StepTime); //BaseTurnRate = degree/second, StepTime = second/step
+	}
+}
+
+void AShooterCharacter::Turn(float Value)
+{
+	float TurnScaleFactor = 0.f;
+	if (bAiming)
+	{
+		TurnScaleFactor = MouseAimingTurnRate;
+	}
+	else
+	{
+		TurnScaleFactor = MouseHipTurnRate;
+	}
+	AddControllerYawInput(Value * TurnScaleFactor); 
+}
+
+void AShooterCharacter::LookUp(float Value)
+{
+	float LookUpScaelFactor = 0.f;
+	if (bAiming)
+	{
+		LookUpScaelFactor = MouseAimingLookUpRate;
+	}
+	else
+	{
+		LookUpScaelFactor = MouseHipLookUpRate;
+	}
+	AddControllerPitchInput(Value * LookUpScaelFactor);
+}
+
+void AShooterCharacter::FireWeapon()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AShooterCharacter::FireWeapon);
+	SHOOTER_HITCH_SCOPE("FireWeapon");
+	SHOOTER_ALLOCATION_SCOPE("FireWeapon");
+	FShooterShotLatencyTracker& LatencyTracker = FShooterShotLatencyTracker::Get();
+	const uint32 ShotId = LatencyTracker.BeginShot();
+
+	if (FireSound)
+	{
+		UGameplayStatics::PlaySound2D(this, FireSound);
+	}
+	FTransform SocketTransform;
+	if (GetMuzzleTransform(SocketTransform))
+	{
+		if (MuzzleFlash)
+		{
+			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlash, SocketTransform);
+			LatencyTracker.MarkStage(ShotId, EShotLatencyStage::MuzzleFX);
+		}
+
+		if (FireMode == EShooterFireMode::EFM_Shotgun || FireMode == EShooterFireMode::EFM_Penetrating)
+		{
+			FireShotBatch(SocketTransform);
+			LatencyTracker.MarkStage(ShotId, EShotLatencyStage::TraceResolved);
+		}
+		else
+		{
+			FVector BeamEnd;
+			FHitResult ImpactHit;
+			bool bBeamEnd = GetBeamEndLocation(SocketTransform.GetLocation(), BeamEnd, ImpactHit);
+			LatencyTracker.MarkStage(ShotId, EShotLatencyStage::TraceResolved);
+
+			if (bBeamEnd)
+			{
+				// Spawn impact particles after updating BeamEndPoint
+				PlayWeaponImpact(GetWorld(), ImpactHit, ImpactResponses, ImpactParticle);
+
+				if (BeamParticles)
+				{
+					UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BeamParticles, SocketTransform);
+					if (Beam)
+					{
+						Beam->SetVectorParameter(FName("Target"), BeamEnd);
+					}
+
+				}
+			}
+
+		}
+	}
+	// Recoil Animation 
+	PlayRecoil();
+
+	// Start bullet fire timer for crosshairs
+	StartCrosshairBulletFire();
+
+	LatencyTracker.SubmitShot(ShotId);
+}
+
+bool AShooterCharacter::GetMuzzleTransform(FTransform& OutTransform) const
+{
+	if (const AWeapon* EquippedWeapon = GetEquippedWeapon())
+	{
+		return EquippedWeapon->GetMuzzleTransform(OutTransform);
+	}
+	if (BarrelSocket.IsValid())
+	{
+		OutTransform = BarrelSocket.GetWorldTransform(GetMesh());
+		return true;
+	}
+	return false;
+}
+
+void AShooterCharacter::PlayRecoil()
+{
+	if (bUseProceduralRecoil)
+	{
+		++ShotCounter; // Anim instance picks the new shot up on its worker thread update
+		return;
+	}
+
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (AnimInstance && HipFireMontage)
+	{
+		AnimInstance->Montage_Play(HipFireMontage);
+		AnimInstance->Montage_JumpToSection(FName("StartFire"));
+	}
+}
+
+bool AShooterCharacter::GetCrosshairWorldRay(FVector& OutPosition, FVector& OutDirection) const
+{
+	// Get Viewport Size
+	FVector2D ViewportSize;
+	if (GEngine && GEngine->GameViewport)
+	{
+		GEngine->GameViewport->GetViewportSize(ViewportSize);
+	}
+	
+	// Get screen space of crosshairs
+	FVector2D CrosshairLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
+
+	// Get world position and direction of crosshairs
+	return UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0), CrosshairLocation,
+		OutPosition,
+		OutDirection);
+}
+
+bool AShooterCharacter::GetBeamEndLocation(const FVector& MuzzleSocketLocation, FVector& OutBeamLocation, FHitResult& OutImpactHit)
+{
+	FVector CrosshairWorldPosition;
+	FVector CrosshairWorldDirection;
+	bool bScreenToWorld = GetCrosshairWorldRay(CrosshairWorldPosition, CrosshairWorldDirection);
+
+	if (bScreenToWorld) // was deprojection succesfull?
+	{
+		FHitResult ScreenTraceHit;
+		const FVector Start = CrosshairWorldPosition;
+		const FVector End = Start + CrosshairWorldDirection * 50'000.f;
+
+		// Set beam end point to line trace end point
+		OutBeamLocation = End;
+
+		// Simple collision only, characters are hit on their physics asset bodies. Physical material picks the impact response
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterWeaponTrace), false, this);
+		QueryParams.bReturnPhysicalMaterial = true;
+
+		// Trace outward from crosshairs world location
+		GetWorld()->LineTraceSingleByChannel(ScreenTraceHit, Start, End, COLLISION_WEAPON, QueryParams);
+
+		if (ScreenTraceHit.bBlockingHit) // did trace hit?
+		{
+			// Beam end point is now trace hit location
+			OutBeamLocation = ScreenTraceHit.Location;
+			OutImpactHit = ScreenTraceHit;
+			
+			ApplyWeaponDamage(ScreenTraceHit, WeaponDamage, CrosshairWorldDirection, this, ImpactResponses);
+
+
+			// Second trace from gun barrel
+			FHitResult WeaponTraceHit;
+			const FVector WeaponTraceStart = MuzzleSocketLocation;
+			const FVector WeaponTraceEnd = OutBeamLocation;
+			GetWorld()->LineTraceSingleByChannel(WeaponTraceHit, WeaponTraceStart, WeaponTraceEnd, COLLISION_WEAPON, QueryParams);
+
+			if (WeaponTraceHit.bBlockingHit)
+			{																							
+				OutBeamLocation = WeaponTraceHit.Location;
+				OutImpactHit = WeaponTraceHit;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+bool AShooterCharacter::FireShotBatch(const FTransform& MuzzleSocketTransform)
+{
+	FVector CrosshairWorldPosition;
+	FVector CrosshairWorldDirection;
+	if (!GetCrosshairWorldRay(CrosshairWorldPosition, CrosshairWorldDirection))
+	{
+		return false;
+	}
+
+	const bool bShotgun = FireMode == EShooterFireMode::EFM_Shotgun;
+
+	FShooterShotBatch ShotBatch;
+	if (bShotgun)
+	{
+		// Pellet cone widens and narrows with the crosshairs
+		const float ConeHalfAngle = FMath::DegreesToRadians(PelletSpreadAngle * FMath::Max(GetCrosshairSpreadMultiplier(), 0.1f));
+		const FRandomStream PelletStream(FMath::Rand());
+		const int32 NumPellets = FMath::Clamp(PelletCount, 8, 12);
+		for (int32 Pellet = 0; Pellet < NumPellets; ++Pellet)
+		{
+			ShotBatch.AddRay(PelletStream.VRandCone(CrosshairWorldDirection, ConeHalfAngle));
+		}
+	}
+	else
+	{
+		ShotBatch.AddRay(CrosshairWorldDirection);
+	}
+
+	FShooterShotBatchParams Params;
+	Params.ViewLocation = CrosshairWorldPosition;
+	Params.MuzzleLocation = MuzzleSocketTransform.GetLocation();
+	Params.Channel = COLLISION_WEAPON;
+	// Simple collision only, characters are hit on their physics asset bodies. Physical material picks the impact response
+	Params.QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(ShooterWeaponTrace), false, this);
+	Params.QueryParams.bReturnPhysicalMaterial = true;
+	if (!bShotgun)
+	{
+		Params.MaxPenetrations = MaxPenetrations;
+		Params.PenetrationDepth = PenetrationDepth;
+		Params.PenetrationDamageScale = PenetrationDamageScale;
+	}
+	ShotBatch.Evaluate(GetWorld(), Params);
+
+	// Every hit on the same target is merged into one damage event and one impact, world geometry without an actor is keyed by component
+	struct FTargetImpact
+	{
+		FHitResult FirstHit;
+		FVector Direction;
+		float Damage = 0.f;
+	};
+	TMap<const UObject*, FTargetImpact, TInlineSetAllocator<16>> TargetImpacts;
+	for (const FShooterShotRayResult& Ray : ShotBatch.GetResults())
+	{
+		for (int32 HitIndex = 0; HitIndex < Ray.Hits.Num(); ++HitIndex)
+		{
+			const FHitResult& Hit = Ray.Hits[HitIndex];
+			const UObject* Target = Hit.GetActor() ? static_cast<const UObject*>(Hit.GetActor()) : Hit.GetComponent();
+			FTargetImpact* Impact = TargetImpacts.Find(Target);
+			if (Impact == nullptr)
+			{
+				Impact = &TargetImpacts.Add(Target);
+				Impact->FirstHit = Hit;
+				Impact->Direction = Ray.Direction;
+			}
+			Impact->Damage += GetWeaponDamageForHit(Hit, WeaponDamage * Ray.DamageScales[HitIndex], ImpactResponses);
+		}
+	}
+
+	for (const TPair<const UObject*, FTargetImpact>& TargetImpact : TargetImpacts)
+	{
+		const FTargetImpact& Impact = TargetImpact.Value;
+		ApplyScaledWeaponDamage(Impact.FirstHit, Impact.Damage, Impact.Direction, this);
+
+		PlayWeaponImpact(GetWorld(), Impact.FirstHit, ImpactResponses, ImpactParticle);
+
+		// A penetrating round gets a single beam through all of its targets below
+		if (BeamParticles && bShotgun)
+		{
+			UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BeamParticles, MuzzleSocketTransform);
+			if (Beam)
+			{
+				Beam->SetVectorParameter(FName("Target"), Impact.FirstHit.Location);
+			}
+		}
+	}
+
+	if (BeamParticles && !bShotgun)
+	{
+		UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BeamParticles, MuzzleSocketTransform);
+		if (Beam)
+		{
+			Beam->SetVectorParameter(FName("Target"), ShotBatch.GetResults()[0].BeamEnd);
+		}
+	}
+	return TargetImpacts.Num() > 0;
+}
+
+void AShooterCharacter::AimingButtonPressed()
+{
+	bAiming = true;
+	CameraRig->SetTargetFOV(CameraZoomedFOV, ZoomInterpSpeed); // Zoom in
+	AimSpread.SetTarget(GetCrosshairTime(), 0.5f, 20.f);
+	SetLookRates();
+}
+
+void AShooterCharacter::AimingButtonReleased()
+{
+	bAiming = false;
+	CameraRig->SetTargetFOV(CameraDefaultFOV, ZoomInterpSpeed); // Zoom out
+	AimSpread.SetTarget(GetCrosshairTime(), 0.f, 20.f);
+	SetLookRates();
+}
+
+void AShooterCharacter::SetLookRates()
+{
+	if (bAiming)
+	{
+		BaseTurnRate = AimingTurnRate;
+		BaseLookUpRate = AimingLookUpRate;
+	}
+	else
+	{
+		BaseTurnRate = HipTurnRate;
+		BaseLookUpRate = HipLookUpRate;
+	}
+}
+
+// Dash ability 
+// This can be re-done with using Apply Root Motion Constant Force function in Unreal's Game Ability System
+void AShooterCharacter::DashAbility()
+{
+	SHOOTER_HITCH_SCOPE("Dash");
+	SHOOTER_ALLOCATION_SCOPE("Dash");
+	if (!Cooldowns->IsOnCooldown(ShooterCharacterCooldowns::Dash))
+	{
+			if(GetVelocity().Normalize()) // if character has velocity 
+			{
+				
+				if (!GetCharacterMovement()->IsFalling())
+				{
+					Cooldowns->StartCooldown(ShooterCharacterCooldowns::Dash, DashCooldown); //Ability cooldown
+					if (DashSound)
+					{
+						UGameplayStatics::PlaySound2D(this, DashSound);
+					}
+					
+					FVector LaunchVelocity = this->GetVelocity() * ForceMultiplier;
+					LaunchCharacter(LaunchVelocity, true, false);
+					GetMovementComponent()->StopMovementKeepPathing();
+				}
+			}
+			
+	}
+}
+
+// Calculate Cross hair spread based on character's movement
+void AShooterCharacter::CalculateCrossHairSpread(float DeltaTime)
+{
+	CrosshairVelocityFactor = GetCrosshairVelocityFactor();
+	if (bClosedFormCrosshairSpread)
+	{
+		// Factors are still written for blueprints reading them
+		const float Time = GetCrosshairTime();
+		CrosshairInAirFactor = InAirSpread.Evaluate(Time);
+		CrosshairAimFactor = AimSpread.Evaluate(Time);
+		CrosshairShootingFactor = ShootingSpread.Evaluate(Time);
+	}
+	else
+	{
+		if (GetCharacterMovement()->IsFalling()) // Is character in air?
+		{
+			// Spread crosshair slowly while in the air
+			CrosshairInAirFactor = FMath::FInterpTo(CrosshairInAirFactor, 2.25f, DeltaTime, 2.25f);
+		}
+		else 
+		{
+			// Shrink the croshair rapidly while on the ground
+			CrosshairInAirFactor = FMath::FInterpTo(CrosshairInAirFactor, 0.f, DeltaTime, 30.f);
+		}
+		if (bAiming) // Is Character aiming?
+		{
+			CrosshairAimFactor = FMath::FInterpTo(CrosshairAimFactor, 0.5f, DeltaTime, 20.f);
+		}
+		else // Character is not aiming
+		{
+			CrosshairAimFactor = FMath::FInterpTo(CrosshairAimFactor, 0.f, DeltaTime, 20.f);
+		}
+		// true 0.05 second after firing
+		if (Cooldowns->IsOnCooldown(ShooterCharacterCooldowns::ShotSpread))
+		{
+			CrosshairShootingFactor = FMath::FInterpTo(CrosshairShootingFactor, 0.3f, DeltaTime, 60.f);
+		}
+		else
+		{
+			CrosshairShootingFactor = FMath::FInterpTo(CrosshairShootingFactor, 0.f, DeltaTime, 60.f);
+		}
+	}
+
+	CrosshairSpreadMultiplier = 0.5f + CrosshairVelocityFactor + CrosshairInAirFactor - CrosshairAimFactor + CrosshairShootingFactor;
+
+	if (FMath::Abs(CrosshairSpreadMultiplier - BroadcastCrosshairSpread) > CrosshairSpreadChangeThreshold)
+	{
+		BroadcastCrosshairSpread = CrosshairSpreadMultiplier;
+		CrosshairSpreadChangedEvent.Broadcast(CrosshairSpreadMultiplier);
+	}
+}
+
+float AShooterCharacter::GetCrosshairVelocityFactor() const
+{
+	FVector2D WalkSpeedRange = FVector2D(0.f, 600.f);
+	FVector2D VelocityMultiplierRange = FVector2D(0.f, 1.f);
+	FVector Velocity = GetVelocity();
+	Velocity.Z = 0.f;
+
+	return FMath::GetMappedRangeValueClamped(WalkSpeedRange, VelocityMultiplierRange, Velocity.Size());
+}
+
+float AShooterCharacter::GetCrosshairTime() const
+{
+	const float WorldTime = static_cast<float>(GetWorld()->GetTimeSeconds());
+	return CrosshairTimeBase + (WorldTime - CrosshairWorldTimeBase) * CustomTimeDilation;
+}
+
+// Only timestamps, the spread calculation checks them when it runs
+void AShooterCharacter::StartCrosshairBulletFire()
+{
+	if (bClosedFormCrosshairSpread)
+	{
+		ShootingSpread.SetTargetForDuration(GetCrosshairTime(), 0.3f, ShootTimeDuraiton, 0.f, 60.f);
+	}
+	else
+	{
+		Cooldowns->StartCooldown(ShooterCharacterCooldowns::ShotSpread, ShootTimeDuraiton);
+	}
+}
+
+void AShooterCharacter::FireButtonPressed()
+{
+	FShooterShotLatencyTracker::Get().MarkInput();
+
+	if (FireMode == EShooterFireMode::EFM_Auto)
+	{
+		bFireButtonPressed = true;
+		StartFireTimer();
+	}
+	else
+	{
+		FireWeapon();
+	}
+	
+}
+
+void AShooterCharacter::FireButtonReleased()
+{
+	bFireButtonPressed = false;
+}
+
+void AShooterCharacter::StartFireTimer()
+{
+	if (!Cooldowns->IsOnCooldown(ShooterCharacterCooldowns::AutoFire))
+	{
+		FireWeapon();
+		Cooldowns->StartCooldown(ShooterCharacterCooldowns::AutoFire, AutomaticFireRate, FSimpleDelegate::CreateUObject(this, &AShooterCharacter::AutoFireReset));
+	}
+
+}
+
+void AShooterCharacter::AutoFireReset()
+{
+	if (bFireButtonPressed)
+	{
+		StartFireTimer();
+	}
+
+}
+// Cycle single, full auto, shotgun and penetrating shots
+void AShooterCharacter::SwitchBetweenShootingModes()
+{
+	FireMode = static_cast<EShooterFireMode>((static_cast<uint8>(FireMode) + 1) % static_cast<uint8>(EShooterFireMode::EFM_MAX));
+	bFireButtonPressed = false;
+
+	UGameplayStatics::PlaySound2D(this, SwitchModeSound);
+
+}
+
+
+//Switches camera shoulder
+void AShooterCharacter::SwitchCameraSides()
+{	
+	CameraYOffset *= -1.f;
+	const FVector TargetOffset = FVector(CameraBoom->SocketOffset.X, CameraYOffset, CameraBoom->SocketOffset.Z);
+	CameraRig->SetTargetSocketOffset(TargetOffset, CameraSideInterpSpeed); // Slide to the other shoulder
+}
+
+// Activate or deactive the slow motion
+void AShooterCharacter::SlowMotionAbility()
+{
+	SHOOTER_HITCH_SCOPE("SlowMotion");
+	SHOOTER_ALLOCATION_SCOPE("SlowMotion");
+	UShooterTimeDilationSubsystem* TimeDilation = GetWorld()->GetSubsystem<UShooterTimeDilationSubsystem>();
+	if (TimeDilation == nullptr)
+	{
+		return;
+	}
+
+	if(!bSlowMoActive)
+	{
+		bSlowMoActive = true;
+		UGameplayStatics::PlaySound2D(this, SlowMoBeginSound);
+		// Only actors around the character slow down, the rest of the world keeps its rate
+		SlowMoScopeId = TimeDilation->AddRegionScope(this, SlowMoRadius, SlowMoDilation);
+	}
+	else
+	{
+		bSlowMoActive = false;
+		UGameplayStatics::PlaySound2D(this, SlowMoEndSound);
+		TimeDilation->RemoveScope(SlowMoScopeId);
+		SlowMoScopeId = INDEX_NONE;
+
+	}
+
+}
+
+// Keep running cooldowns in step with this character's time
+void AShooterCharacter::OnCustomTimeDilationChanged(float OldDilation, float NewDilation)
+{
+	Cooldowns->RescaleCooldowns(OldDilation / FMath::Max(NewDilation, KINDA_SMALL_NUMBER));
+
+	// Crosshair time advanced at the old rate until now
+	const float WorldTime = static_cast<float>(GetWorld()->GetTimeSeconds());
+	CrosshairTimeBase += (WorldTime - CrosshairWorldTimeBase) * OldDilation;
+	CrosshairWorldTimeBase = WorldTime;
+}
+
+
+// Spawn and control drone
+void AShooterCharacter::DroneAbility()
+{
+	// If you possess the drone while character is in the air, character will be hang in air. This prevents that bug
+	if (!GetCharacterMovement()->IsFalling()) 
+	{
+		StartDroneControl();
+
+		// Needs a skill cooldown
+
+	}
+	
+}
+
+void AShooterCharacter::StartDroneControl()
+{
+	SHOOTER_HITCH_SCOPE("StartDroneControl");
+	SHOOTER_ALLOCATION_SCOPE("StartDroneControl");
+	APlayerController* PlayerController = Cast<APlayerController>(GetController());
+	if (PlayerController == nullptr || bControllingDrone)
+	{
+		return;
+	}
+
+	FVector Location = FVector(GetActorLocation().X, GetActorLocation().Y + 50.f, GetActorLocation().Z + 200);
+	FTransform DroneTransform = GetActorTransform();
+	DroneTransform.SetLocation(Location); // Drone will spawn at top of the character
+
+	if (MyDrone && MyDrone->IsParked())
+	{
+		// Reuse the drone parked by the last switch back
+		MyDrone->SetActorTransform(DroneTransform, false, nullptr, ETeleportType::ResetPhysics);
+		MyDrone->SetParked(false);
+	}
+	else
+	{
+		// Spawn the drone
+		MyDrone = GetWorld()->SpawnActorDeferred<ADrone>(Drone, DroneTransform, this, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (MyDrone)
+		{
+			MyDrone->FinishSpawning(DroneTransform);
+		}
+	}
+	if (MyDrone == nullptr)
+	{
+		return;
+	}
+	MyDrone->SetRangeAnchor(this);
+
+	// If you possess the drone while running character will stuck in that running animation. This prevents that bug
+	GetCharacterMovement()->StopMovementKeepPathing();
+
+	if (bFastPawnSwitch)
+	{
+		// Character stays possessed, only the active input and the view target move to the drone
+		DisableInput(PlayerController);
+		// Axis bindings stop being called, a held stick would keep turning the shared control rotation from the fixed step
+		LookUpRateInput = 0.f;
+		TurnRateInput = 0.f;
+		MyDrone->BeginExternalControl(PlayerController);
+		PlayerController->SetViewTargetWithBlend(MyDrone, DroneViewBlendTime);
+		if (AShooterHUD* HUD = Cast<AShooterHUD>(PlayerController->GetHUD()))
+		{
+			HUD->SetActivePawn(MyDrone);
+		}
+	}
+	else
+	{
+		PlayerController->Possess(MyDrone); // Control the drone
+	}
+	bControllingDrone = true;
+
+	// Drone control duration can be changed via DroneTime
+	Cooldowns->StartCooldown(ShooterCharacterCooldowns::DroneControl, DroneTime, FSimpleDelegate::CreateUObject(this, &AShooterCharacter::DroneToPlayer));
+}
+
+void AShooterCharacter::DroneToPlayer()
+{
+	SHOOTER_HITCH_SCOPE("DroneToPlayer");
+	SHOOTER_ALLOCATION_SCOPE("DroneToPlayer");
+	if (!bControllingDrone)
+	{
+		return;
+	}
+	bControllingDrone = false;
+	Cooldowns->ClearCooldown(ShooterCharacterCooldowns::DroneControl);
+	if (MyDrone == nullptr)
+	{
+		return;
+	}
+
+	if (APlayerController* PlayerController = MyDrone->GetExternalController())
+	{
+		MyDrone->EndExternalControl();
+		EnableInput(PlayerController);
+		PlayerController->SetViewTargetWithBlend(this, DroneViewBlendTime);
+		if (AShooterHUD* HUD = Cast<AShooterHUD>(PlayerController->GetHUD()))
+		{
+			HUD->SetActivePawn(this);
+		}
+		MyDrone->SetParked(true); // Kept for the next use
+	}
+	else
+	{
+		UGameplayStatics::GetPlayerController(GetWorld(), 0)->Possess(this); // posses player back
+
+		MyDrone->Destroy(); // Destroy the drone
+		MyDrone = nullptr;
+	}
+}
+
+APawn* AShooterCharacter::GetActiveInputPawn()
+{
+	if (bControllingDrone && MyDrone && MyDrone->GetExternalController())
+	{
+		return MyDrone;
+	}
+	return this;
+}
+
+float AShooterCharacter::GetDamageMultiplierForBone(FName BoneName) const
+{
+	const float* Multiplier = BoneDamageMultipliers.Find(BoneName);
+	return Multiplier ? *Multiplier : 1.f;
+}
+
+float AShooterCharacter::GetWeaponDamageForHit(const FHitResult& Hit, float BaseDamage, const UShooterImpactResponseTable* ImpactResponses)
+{
+	float Damage = BaseDamage;
+	if (ImpactResponses)
+	{
+		Damage *= ImpactResponses->GetResponse(Hit).DamageMultiplier;
+	}
+	if (const AShooterCharacter* HitCharacter = Cast<AShooterCharacter>(Hit.GetActor()))
+	{
+		Damage *= HitCharacter->GetDamageMultiplierForBone(Hit.BoneName);
+	}
+	return Damage;
+}
+
+void AShooterCharacter::ApplyWeaponDamage(const FHitResult& Hit, float BaseDamage, const FVector& ShotDirection, AActor* DamageCauser, const UShooterImpactResponseTable* ImpactResponses)
+{
+	ApplyScaledWeaponDamage(Hit, GetWeaponDamageForHit(Hit, BaseDamage, ImpactResponses), ShotDirection, DamageCauser);
+}
+
+void AShooterCharacter::PlayWeaponImpact(UWorld* World, const FHitResult& Hit, const UShooterImpactResponseTable* ImpactResponses, UParticleSystem* FallbackParticle)
+{
+	if (ImpactResponses)
+	{
+		ImpactResponses->PlayImpact(World, Hit);
+	}
+	else if (FallbackParticle)
+	{
+		UGameplayStatics::SpawnEmitterAtLocation(World, FallbackParticle, Hit.Location);
+	}
+}
+
+void AShooterCharacter::ApplyScaledWeaponDamage(const FHitResult& Hit, float Damage, const FVector& ShotDirection, AActor* DamageCauser)
+{
+	AActor* HitActor = Hit.GetActor();
+	if (HitActor == nullptr)
+	{
+		return;
+	}
+
+	const APawn* CauserPawn = Cast<APawn>(DamageCauser);
+	AController* InstigatorController = CauserPawn ? CauserPawn->GetController() : nullptr;
+	UGameplayStatics::ApplyPointDamage(HitActor, Damage, ShotDirection, Hit, InstigatorController, DamageCauser, nullptr);
+}
+
+void AShooterCharacter::UpdateFocusedItems(float DeltaTime)
+{
+	// Only the local player sees pickup widgets, not while flying the drone
+	if (!IsLocallyControlled() || bControllingDrone)
+	{
+		return;
+	}
+
+	TArray<FOverlapResult> Overlaps;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterItemFocus), false, this);
+	GetWorld()->OverlapMultiByObjectType(Overlaps, GetActorLocation(), FQuat::Identity, FCollisionObjectQueryParams(ECC_WorldDynamic), FCollisionShape::MakeSphere(ItemFocusRadius), QueryParams);
+
+	// Items closest to the center of the screen get a widget first
+	const FVector ViewLocation = FollowCamera->GetComponentLocation();
+	const FVector ViewDirection = FollowCamera->GetForwardVector();
+	const float MinFocusDot = FMath::Cos(FMath::DegreesToRadians(ItemFocusAngle));
+	TArray<TPair<float, AItem*>, TInlineAllocator<8>> Candidates;
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		AItem* Item = Cast<AItem>(Overlap.GetActor());
+		if (Item == nullptr || Candidates.ContainsByPredicate([Item](const TPair<float, AItem*>& Candidate) { return Candidate.Value == Item; }))
+		{
+			continue;
+		}
+		const float FocusDot = (Item->GetActorLocation() - ViewLocation).GetSafeNormal() | ViewDirection;
+		if (FocusDot >= MinFocusDot)
+		{
+			Candidates.Emplace(FocusDot, Item);
+		}
+	}
+	Candidates.Sort([](const TPair<float, AItem*>& A, const TPair<float, AItem*>& B) { return A.Key > B.Key; });
+
+	TArray<AItem*> FocusedItems;
+	FocusedItems.Reserve(Candidates.Num());
+	for (const TPair<float, AItem*>& Candidate : Candidates)
+	{
+		FocusedItems.Add(Candidate.Value);
+	}
+	FocusedItem = FocusedItems.Num() > 0 ? FocusedItems[0] : nullptr;
+
+	APlayerController* PlayerController = Cast<APlayerController>(GetController());
+	if (AShooterHUD* ShooterHUD = PlayerController ? Cast<AShooterHUD>(PlayerController->GetHUD()) : nullptr)
+	{
+		ShooterHUD->SetFocusedItems(FocusedItems);
+	}
+}
+
+void AShooterCharacter::SpawnWeaponPool()
+{
+	SHOOTER_HITCH_SCOPE("SpawnWeaponPool");
+	for (const TSubclassOf<AWeapon>& WeaponClass : DefaultWeapons)
+	{
+		if (WeaponClass == nullptr || WeaponPool.Num() >= MaxWeapons)
+		{
+			continue;
+		}
+
+		// Stowed before BeginPlay so the weapon never registers as a dropped item
+		AWeapon* Weapon = GetWorld()->SpawnActorDeferred<AWeapon>(WeaponClass, GetActorTransform(), this, this, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (Weapon == nullptr)
+		{
+			continue;
+		}
+		Weapon->SetItemState(EItemState::EIS_Stowed);
+		Weapon->FinishSpawning(GetActorTransform());
+		Weapon->AttachToComponent(GetMesh(), FAttachmentTransformRules::SnapToTargetNotIncludingScale, WeaponHandSocketName);
+		WeaponPool.Add(Weapon);
+	}
+
+	if (WeaponPool.Num() > 0)
+	{
+		EquipWeapon(0);
+	}
+}
+
+void AShooterCharacter::EquipWeapon(int32 PoolIndex)
+{
+	SHOOTER_HITCH_SCOPE("EquipWeapon");
+	if (PoolIndex == EquippedWeaponIndex || !WeaponPool.IsValidIndex(PoolIndex))
+	{
+		return;
+	}
+
+	if (AWeapon* PreviousWeapon = GetEquippedWeapon())
+	{
+		PreviousWeapon->Stow();
+	}
+	WeaponPool[PoolIndex]->Equip(GetMesh(), WeaponHandSocketName);
+	EquippedWeaponIndex = PoolIndex;
+}
+
+void AShooterCharacter::SwapToNextWeapon()
+{
+	if (WeaponPool.Num() > 1)
+	{
+		EquipWeapon((EquippedWeaponIndex + 1) % WeaponPool.Num());
+	}
+}
+
+void AShooterCharacter::PickupFocusedWeapon()
+{
+	AWeapon* Weapon = Cast<AWeapon>(FocusedItem.Get());
+	if (Weapon == nullptr || Weapon->GetItemState() != EItemState::EIS_Dropped)
+	{
+		return;
+	}
+	Weapon->SetOwner(this);
+	FocusedItem = nullptr;
+
+	if (WeaponPool.Num() < MaxWeapons)
+	{
+		EquipWeapon(WeaponPool.Add(Weapon));
+		return;
+	}
+
+	// Pool is full, the equipped weapon is left where the new one was
+	AWeapon* PreviousWeapon = GetEquippedWeapon();
+	const FTransform DropTransform = Weapon->GetActorTransform();
+	WeaponPool[EquippedWeaponIndex] = Weapon;
+	Weapon->Equip(GetMesh(), WeaponHandSocketName);
+	PreviousWeapon->Drop(DropTransform);
+}
+
+float AShooterCharacter::GetCrosshairSpreadMultiplier() const
+{
+	if (!bClosedFormCrosshairSpread)
+	{
+		return CrosshairSpreadMultiplier;
+	}
+	const float Time = GetCrosshairTime();
+	return 0.5f + GetCrosshairVelocityFactor() + InAirSpread.Evaluate(Time) - AimSpread.Evaluate(Time) + ShootingSpread.Evaluate(Time);
+}
+
+float FShooterSpreadFactor::Evaluate(float Time) const
+{
+	// Continuous form of FInterpTo: the distance to the target shrinks by e^(-InterpSpeed * t)
+	auto Approach = [this](float From, float To, float Elapsed)
+	{
+		return To + (From - To) * FMath::Exp(-InterpSpeed * FMath::Max(Elapsed, 0.f));
+	};
+	if (Time <= ReleaseTime)
+	{
+		return Approach(StartValue, Target, Time - StartTime);
+	}
+	const float ReleaseValue = Approach(StartValue, Target, ReleaseTime - StartTime);
+	return Approach(ReleaseValue, ReleaseTarget, Time - ReleaseTime);
+}
+
+void FShooterSpreadFactor::SetTarget(float Time, float NewTarget, float NewInterpSpeed)
+{
+	StartValue = Evaluate(Time);
+	StartTime = Time;
+	Target = NewTarget;
+	InterpSpeed = NewInterpSpeed;
+	ReleaseTime = TNumericLimits<float>::Max();
+}
+
+void FShooterSpreadFactor::SetTargetForDuration(float Time, float NewTarget, float HoldDuration, float NewReleaseTarget, float NewInterpSpeed)
+{
+	SetTarget(Time, NewTarget, NewInterpSpeed);
+	ReleaseTime = Time + HoldDuration;
+	ReleaseTarget = NewReleaseTarget;
+}
+
+// Called to bind functionality to input
+void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
+{
+	Super::SetupPlayerInputComponent(PlayerInputComponent);
+	
+	check(PlayerInputComponent);
+
+	PlayerInputComponent->BindAxis("MoveForward", this, &AShooterCharacter::MoveForward);
+	PlayerInputComponent->BindAxis("MoveRight", this, &AShooterCharacter::MoveRight);
+	PlayerInputComponent->BindAxis("TurnRate", this, &AShooterCharacter::TurnAtRate);
+	PlayerInputComponent->BindAxis("LookUpRate", this, &AShooterCharacter::LookUpAtRate);
+	PlayerInputComponent->BindAxis("Turn", this, &AShooterCharacter::Turn);
+	PlayerInputComponent->BindAxis("LookUp", this, &AShooterCharacter::LookUp);
+
+	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &ACharacter::Jump);
+	PlayerInputComponent->BindAction("Jump", IE_Released, this, &ACharacter::StopJumping);
+
+	PlayerInputComponent->BindAction("FireButton", IE_Pressed, this, &AShooterCharacter::FireButtonPressed);
+	PlayerInputComponent->BindAction("FireButton", IE_Released, this, &AShooterCharacter::FireButtonReleased);
+
+	PlayerInputComponent->BindAction("AimingButton", IE_Pressed, this, &AShooterCharacter::AimingButtonPressed);
+	PlayerInputComponent->BindAction("AimingButton", IE_Released, this, &AShooterCharacter::AimingButtonReleased);
+
+	PlayerInputComponent->BindAction("Dash", IE_Pressed, this, &AShooterCharacter::DashAbility);
+	
+	PlayerInputComponent->BindAction("SwitchBetweenWeaponModes", IE_Pressed, this, &AShooterCharacter::SwitchBetweenShootingModes);
+
+	PlayerInputComponent->BindAction("SwitchCameraSides", IE_Pressed, this, &AShooterCharacter::SwitchCameraSides);
+
+	PlayerInputComponent->BindAction("SlowMotion", IE_Pressed, this, &AShooterCharacter::SlowMotionAbility);
+
+	PlayerInputComponent->BindAction("DroneAbility", IE_Pressed, this, &AShooterCharacter::DroneAbility);
+
+	PlayerInputComponent->BindAction("SwapWeapon", IE_Pressed, this, &AShooterCharacter::SwapToNextWeapon);
+
+	PlayerInputComponent->BindAction("Select", IE_Pressed, this, &AShooterCharacter::PickupFocusedWeapon);
+
+	
+
+}
@@ -1,293 +1,519 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Character.h"
-#include "ShooterCharacter.generated.h"
-
-UCLASS()
-class SHOOTERPROJESI_API AShooterCharacter : public ACharacter
-{
-	GENERATED_BODY()
-
-public:
-	// Sets default values for this character's properties
-	AShooterCharacter();
-
-
-protected:
-	// Called when the game starts or when spawned
-	virtual void BeginPlay() override;
-	
-	// Called for forward/backward input
-	void MoveForward(float Value);
-
-	// Called for side to side input
-	void MoveRight(float Value);
-
-	/*
-		Called via input to look up/down at a given rate
-		@param Rate This is a normalized rate, i.e. 1.0 means 100% of desired rate
-	*/
-	void LookUpAtRate(float Rate);
-
-	/*
-		Called via input to turn at a given rate
-		@param Rate This is a normalized rate, i.e. 1.0 means 100% of desired turn rate
-	*/
-	void TurnAtRate(float Rate);
-
-	// Change the sensivity of mouse APawn::AddControllerYawInput APawn::AddControllerPitchInput
-	void Turn(float Value);
-	void LookUp(float Value);
-
-	//Called when FireButton is pressed
-	void FireWeapon();
-
-	bool GetBeamEndLocation(const FVector& MuzzleSocketLocation, FVector& OutBeamLocation);
-
-	// Set bAiming to true or false
-	void AimingButtonPressed();
-	void AimingButtonReleased();
-
-	void CameraInterpZoom(float Deltatime);
-
-	// Set BaseTurnRate and BaseLookUpRate based on aiming
-	void SetLookRates();
-
-	// Dash Ability
-	void DashAbility();
-
-
-	void SetDashActiveToFalse();
-
-	void CalculateCrossHairSpread(float DeltaTime); // Calculate Cross hair spread based on character's movement
-
-	void StartCrosshairBulletFire();
-
-	UFUNCTION()
-	void FinishCrosshairBulletFire();
-
-	void FireButtonPressed();
-
-	void FireButtonReleased();
-
-	void StartFireTimer();
-
-	UFUNCTION()
-	void AutoFireReset();
-
-	// Set bSwitchToAuto to true or false
-	void SwitchBetweenShootingModes();
-
-	// Switches camera side 
-	void SwitchCameraSides();
-
-	// SlowMotionAbility
-	void SlowMotionAbility();
-
-	// Spawn a Drone and posses it
-	void DroneAbility();
-
-
-
-public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
-	// Called to bind functionality to input
-	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
-
-	void DroneToPlayer();
-
-private:
-	
-	/* Camera boom positioning the camera behind the character */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
-	class USpringArmComponent* CameraBoom;
-
-	/* Camera that follows character */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
-	class UCameraComponent* FollowCamera;
-
-	UPROPERTY(VisibleAnywhere, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
-	float BaseTurnRate;
-
-	UPROPERTY(VisibleAnywhere, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
-	float BaseLookUpRate;
-
-	// Turn rate while not aiming
-	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
-	float HipTurnRate;
-
-	// Look up rate while not aiming
-	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
-	float HipLookUpRate;
-
-	// Turn rate while aiming
-	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
-	float AimingTurnRate;
-
-	// Look up rate while aiming
-	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
-	float AimingLookUpRate;
-
-	// Scale factor for mouse turn sensitivy not Aiminig
-	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"), meta = (ClampMin = "0.0", ClampMax = 1.0, UIMin = "0.0", UIMax = "1.0"))
-	float MouseHipTurnRate;
-
-	// Scale factor for mouse look sensitivy not Aiminig
-	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"), meta = (ClampMin = "0.0", ClampMax = 1.0, UIMin = "0.0", UIMax = "1.0"))
-	float MouseHipLookUpRate;
-
-	// Scale factor for mouse turn sensitivy while Aiminig
-	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"), meta = (ClampMin = "0.0", ClampMax = 1.0, UIMin = "0.0", UIMax = "1.0"))
-	float MouseAimingTurnRate;
-
-	// Scale factor for mouse look sensitivy while Aiminig
-	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"), meta = (ClampMin = "0.0", ClampMax = 1.0, UIMin = "0.0", UIMax = "1.0"))
-	float MouseAimingLookUpRate;
-
-	// Randomized 6 shot sound cue
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess="True"))
-	class USoundCue* FireSound;
-	
-	// Flash spawned at BarrelSocket when gun fired
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
-	class UParticleSystem* MuzzleFlash;
-	
-	// Montage for firing weapon
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
-	class UAnimMontage* HipFireMontage;
-
-	// Particle for bullet impact
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
-	UParticleSystem* ImpactParticle;
-
-	// Smoke trail for bullet
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
-	UParticleSystem* BeamParticles;
-
-	// Is Character aiming
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
-	bool bAiming;
-
-	// Default camera field of view value
-	float CameraDefaultFOV;
-	// Camera zoomed field of view value
-	float CameraZoomedFOV;
-	// Current camera field of view
-	float CameraCurrentFOV;
-	
-	// Interp speed for aiming
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
-	float ZoomInterpSpeed;
-
-	// Is Dash ability available? 
-	bool bIsDashActive;
-
-	
-	// Timer handle for dash cooldown
-	FTimerHandle DashTimer;
-	
-	// Dash cooldown
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat | Dash", meta = (AllowPrivateAccess = "true"))
-	float DashCooldown;
-	
-	// Force multiplier for Dash ability
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat | Dash", meta = (AllowPrivateAccess = "true"))
-	float ForceMultiplier;
-
-	
-	// Determines the spread of the crosshairs
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
-	float CrosshairSpreadMultiplier;
-	
-	// Velocity component for crosshairs spread
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
-	float CrosshairVelocityFactor;
-
-	// In air component for crosshairs spread
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
-	float CrosshairInAirFactor;
-
-	// Aim component for crosshair spread
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
-	float CrosshairAimFactor;
-
-	// Shooting component for crosshair spread
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
-	float CrosshairShootingFactor;
-
-	// Time duration for crosshair set timer
-	float ShootTimeDuraiton;
-
-	// Is character shooting?
-	bool bFiringBullet;
-
-	// Timer handle for crosshair shoot spread
-	FTimerHandle CrosshairShootTimer;
-
-	// Left mouse button or right gamepad trigger pressed
-	bool bFireButtonPressed;
-
-	// True when we can fire, false when waiting for timer
-	bool bShouldFire;
-
-	// Fire rate of rifle
-	float AutomaticFireRate;
-
-	//	Sets a timer between gunshots
-	FTimerHandle AutoFireTimerHandle;
-
-	// Switch between singular shots to automatic 
-	bool bSwitchToAuto;
-
-	// Camera Y off set value
-	float CameraYOffset;
-		
-	bool bSlowMoActive;
-
-
-	// Drone Time
-	UPROPERTY(meta = (AllowPrivateAccess = "true"))
-	FTimerHandle DroneTimerHandle;
-	
-
-	// Drone control duration
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Drone Ability", meta = (AllowPrivateAccess = "true"))
-	float DroneTime;
-
-	// Drone
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
-	TSubclassOf<APawn> Drone;
-	UPROPERTY(EditAnywhere, meta = (AllowPrivateAccess = "true"))
-	class ADrone* MyDrone;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
-	USoundCue* DashSound;
-	
-	// Sound effects for the time slow
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
-	USoundCue* SlowMoBeginSound;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
-	USoundCue* SlowMoEndSound;
-	
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
-	USoundWave* SwitchModeSound;
-
-public:
-	/* Returns CameraBoom subobject */
-	FORCEINLINE USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
-	/* Returns FollowCamera subobject */
-	FORCEINLINE UCameraComponent* GetFollowCamera() const { return FollowCamera; }
-
-	FORCEINLINE bool GetAiming() const { return bAiming; }
-
-
-	UFUNCTION(BlueprintCallable)
-	float GetCrosshairSpreadMultiplier() const;
-
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Character.h"
+#include "ShooterTimeDilationSubsystem.h"
+#include "Weapon.h"
+#include "ShooterCharacter.generated.h"
+
+UENUM(BlueprintType)
+enum class EShooterFireMode : uint8
+{
+	EFM_Single UMETA(DisplayName = "Single"),
+	EFM_Auto UMETA(DisplayName = "Auto"),
+	EFM_Shotgun UMETA(DisplayName = "Shotgun"),			// PelletCount pellets spread around the crosshairs
+	EFM_Penetrating UMETA(DisplayName = "Penetrating"),	// One round passing through up to MaxPenetrations surfaces
+
+	EFM_MAX UMETA(Hidden)
+};
+
+// Broadcast when the crosshair spread multiplier moved more than CrosshairSpreadChangeThreshold
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCrosshairSpreadChanged, float /*SpreadMultiplier*/);
+
+/*
+	One crosshair spread factor easing towards a target, evaluated in closed form from the time the target was set.
+	Follows the exponential curve FInterpTo approaches, so the result is the same at any frame rate and nothing needs to tick.
+	After ReleaseTime the factor eases towards ReleaseTarget instead.
+*/
+struct FShooterSpreadFactor
+{
+	float StartTime = 0.f;
+	float StartValue = 0.f;
+	float Target = 0.f;
+	float InterpSpeed = 0.f;
+	float ReleaseTime = TNumericLimits<float>::Max();
+	float ReleaseTarget = 0.f;
+
+	float Evaluate(float Time) const;
+
+	// Eases from the current value towards NewTarget from Time on
+	void SetTarget(float Time, float NewTarget, float NewInterpSpeed);
+
+	// Eases towards NewTarget for HoldDuration, then back towards NewReleaseTarget
+	void SetTargetForDuration(float Time, float NewTarget, float HoldDuration, float NewReleaseTarget, float NewInterpSpeed);
+};
+
+UCLASS()
+class SHOOTERPROJESI_API AShooterCharacter : public ACharacter, public IShooterTimeDilationListener
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this character's properties
+	AShooterCharacter();
+
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Registers crosshair spread and item focus with the gameplay task scheduler, look rates with the fixed step
+	void RegisterScheduledTasks();
+
+	// The crosshair spread task only runs for locally controlled characters when spread is evaluated in closed form
+	void UpdateCrosshairSpreadTask();
+
+	// Starts easing the in air spread factor when the character starts or stops falling
+	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
+	
+	// Called for forward/backward input
+	void MoveForward(float Value);
+
+	// Called for side to side input
+	void MoveRight(float Value);
+
+	/*
+		Called via input to look up/down at a given rate
+		@param Rate This is a normalized rate, i.e. 1.0 means 100% of desired rate
+	*/
+	void LookUpAtRate(float Rate);
+
+	/*
+		Called via input to turn at a given rate
+		@param Rate This is a normalized rate, i.e. 1.0 means 100% of desired turn rate
+	*/
+	void TurnAtRate(float Rate);
+
+	// Applies the gamepad look rates on the fixed step, so turning speed doesn't depend on frame rate
+	void SimulateLookRates(float StepTime);
+
+	// Change the sensivity of mouse APawn::AddControllerYawInput APawn::AddControllerPitchInput
+	void Turn(float Value);
+	void LookUp(float Value);
+
+	//Called when FireButton is pressed
+	void FireWeapon();
+
+	// OutImpactHit is the hit at the beam end, for impact effects
+	bool GetBeamEndLocation(const FVector& MuzzleSocketLocation, FVector& OutBeamLocation, FHitResult& OutImpactHit);
+
+	// World position and direction of the crosshairs at the center of the viewport
+	bool GetCrosshairWorldRay(FVector& OutPosition, FVector& OutDirection) const;
+
+	// Shotgun and penetrating shots, every ray is traced in one parallel batch and hits are merged per target
+	bool FireShotBatch(const FTransform& MuzzleSocketTransform);
+
+	// Set bAiming to true or false
+	void AimingButtonPressed();
+	void AimingButtonReleased();
+
+	// Set BaseTurnRate and BaseLookUpRate based on aiming
+	void SetLookRates();
+
+	// Dash Ability
+	void DashAbility();
+
+	void CalculateCrossHairSpread(float DeltaTime); // Calculate Cross hair spread based on character's movement
+
+	float GetCrosshairVelocityFactor() const;
+
+	// This character's dilated time, the clock closed form spread factors are evaluated with
+	float GetCrosshairTime() const;
+
+	void StartCrosshairBulletFire();
+
+	void FireButtonPressed();
+
+	void FireButtonReleased();
+
+	void StartFireTimer();
+
+	UFUNCTION()
+	void AutoFireReset();
+
+	// Cycle through the fire modes
+	void SwitchBetweenShootingModes();
+
+	// Switches camera side 
+	void SwitchCameraSides();
+
+	// SlowMotionAbility
+	void SlowMotionAbility();
+
+	// Spawn a Drone and posses it
+	void DroneAbility();
+
+	// Finds the items in front of the camera and hands them to the HUD's pickup widgets
+	void UpdateFocusedItems(float DeltaTime);
+
+	// Spawns DefaultWeapons once, they are reused for every swap
+	void SpawnWeaponPool();
+
+	// Stows the equipped weapon and puts the pooled weapon at PoolIndex in hand
+	void EquipWeapon(int32 PoolIndex);
+
+	void SwapToNextWeapon();
+
+	// Adds the focused weapon to the pool, or trades it for the equipped weapon when the pool is full
+	void PickupFocusedWeapon();
+
+	// Muzzle of the equipped weapon, or the character mesh's own barrel socket without one
+	bool GetMuzzleTransform(FTransform& OutTransform) const;
+
+
+
+public:	
+	// Called to bind functionality to input
+	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
+
+	// Moves control to the drone, reusing the parked one. Fast switching keeps the character possessed
+	void StartDroneControl();
+
+	void DroneToPlayer();
+
+	// Pawn whose input component receives the player's input, the drone while it is controlled without possession
+	APawn* GetActiveInputPawn();
+
+	FORCEINLINE bool IsControllingDrone() const { return bControllingDrone; }
+
+	FORCEINLINE void SetFastPawnSwitch(bool bFast) { bFastPawnSwitch = bFast; }
+
+	virtual void OnCustomTimeDilationChanged(float OldDilation, float NewDilation) override;
+
+	virtual void NotifyControllerChanged() override;
+
+	// Recoil for a single shot, procedural layer or HipFireMontage depending on bUseProceduralRecoil
+	void PlayRecoil();
+
+private:
+	
+	/* Camera boom positioning the camera behind the character */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
+	class USpringArmComponent* CameraBoom;
+
+	/* Camera that follows character */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
+	class UCameraComponent* FollowCamera;
+
+	/* Interpolates FOV and shoulder offset of the camera, sleeps when converged */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
+	class UShooterCameraRigComponent* CameraRig;
+
+	/* Dash, auto fire, shot spread and drone control timers as expiry timestamps */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	class UShooterCooldownComponent* Cooldowns;
+
+	UPROPERTY(VisibleAnywhere, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
+	float BaseTurnRate;
+
+	UPROPERTY(VisibleAnywhere, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
+	float BaseLookUpRate;
+
+	// Turn rate while not aiming
+	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
+	float HipTurnRate;
+
+	// Look up rate while not aiming
+	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
+	float HipLookUpRate;
+
+	// Turn rate while aiming
+	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
+	float AimingTurnRate;
+
+	// Look up rate while aiming
+	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"))
+	float AimingLookUpRate;
+
+	// Scale factor for mouse turn sensitivy not Aiminig
+	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"), meta = (ClampMin = "0.0", ClampMax = 1.0, UIMin = "0.0", UIMax = "1.0"))
+	float MouseHipTurnRate;
+
+	// Scale factor for mouse look sensitivy not Aiminig
+	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"), meta = (ClampMin = "0.0", ClampMax = 1.0, UIMin = "0.0", UIMax = "1.0"))
+	float MouseHipLookUpRate;
+
+	// Scale factor for mouse turn sensitivy while Aiminig
+	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"), meta = (ClampMin = "0.0", ClampMax = 1.0, UIMin = "0.0", UIMax = "1.0"))
+	float MouseAimingTurnRate;
+
+	// Scale factor for mouse look sensitivy while Aiminig
+	UPROPERTY(EditDefaultsOnly, BluePrintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "True"), meta = (ClampMin = "0.0", ClampMax = 1.0, UIMin = "0.0", UIMax = "1.0"))
+	float MouseAimingLookUpRate;
+
+	// Randomized 6 shot sound cue
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess="True"))
+	class USoundCue* FireSound;
+	
+	// Flash spawned at BarrelSocket when gun fired
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	class UParticleSystem* MuzzleFlash;
+	
+	// Montage for firing weapon
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	class UAnimMontage* HipFireMontage;
+
+	// Use the anim instance's additive recoil layer instead of restarting HipFireMontage every shot.
+	// Needs an anim blueprint derived from UShooterAnimInstance that applies RecoilAlpha, RecoilPitch and RecoilKickback
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	bool bUseProceduralRecoil;
+
+	// Incremented every shot, read by the anim instance to kick the recoil spring
+	uint32 ShotCounter;
+
+	// Damage of a single shot before hitbox multipliers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	float WeaponDamage;
+
+	// Damage multiplier per physics asset bone, e.g. head
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	TMap<FName, float> BoneDamageMultipliers;
+
+	// Particle for bullet impact, used when there is no ImpactResponses table
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	UParticleSystem* ImpactParticle;
+
+	// Impact effects, decals and damage multipliers per physical surface
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	class UShooterImpactResponseTable* ImpactResponses;
+
+	// Smoke trail for bullet
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	UParticleSystem* BeamParticles;
+
+	// Is Character aiming
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	bool bAiming;
+
+	// Default camera field of view value
+	float CameraDefaultFOV;
+	// Camera zoomed field of view value
+	float CameraZoomedFOV;
+	
+	// Interp speed for aiming
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	float ZoomInterpSpeed;
+
+	// Dash cooldown
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat | Dash", meta = (AllowPrivateAccess = "true"))
+	float DashCooldown;
+	
+	// Force multiplier for Dash ability
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat | Dash", meta = (AllowPrivateAccess = "true"))
+	float ForceMultiplier;
+
+	
+	// Determines the spread of the crosshairs
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	float CrosshairSpreadMultiplier;
+	
+	// Velocity component for crosshairs spread
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	float CrosshairVelocityFactor;
+
+	// In air component for crosshairs spread
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	float CrosshairInAirFactor;
+
+	// Aim component for crosshair spread
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	float CrosshairAimFactor;
+
+	// Shooting component for crosshair spread
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	float CrosshairShootingFactor;
+
+	// Spread change needed before listeners are notified, keeps the crosshair from repainting for invisible changes
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	float CrosshairSpreadChangeThreshold;
+
+	// Spread multiplier listeners were last notified with
+	float BroadcastCrosshairSpread;
+
+	// Evaluate spread factors from the time their state changed instead of interpolating them every frame
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	bool bClosedFormCrosshairSpread;
+
+	FShooterSpreadFactor InAirSpread;
+	FShooterSpreadFactor AimSpread;
+	FShooterSpreadFactor ShootingSpread;
+
+	// GetCrosshairTime at the last time dilation change, and the world time it was taken at
+	float CrosshairTimeBase;
+	float CrosshairWorldTimeBase;
+
+	FOnCrosshairSpreadChanged CrosshairSpreadChangedEvent;
+
+	// Items within this distance can show a pickup widget
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Items", meta = (AllowPrivateAccess = "true"))
+	float ItemFocusRadius;
+
+	// Items within this angle from the camera direction can show a pickup widget
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Items", meta = (AllowPrivateAccess = "true"))
+	float ItemFocusAngle;
+
+	// Seconds between item focus queries
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Items", meta = (AllowPrivateAccess = "true"))
+	float ItemFocusInterval;
+
+	// Scheduled task ids, see RegisterScheduledTasks
+	int32 CrosshairSpreadTaskId;
+	int32 ItemFocusTaskId;
+	int32 LookRatesStepId;
+
+	// Gamepad look rate axis values, applied by SimulateLookRates
+	float LookUpRateInput;
+	float TurnRateInput;
+
+	// Item closest to the center of the screen, picked up by the Select action
+	TWeakObjectPtr<AItem> FocusedItem;
+
+	// Weapons spawned into the pool at BeginPlay
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combat | Weapons", meta = (AllowPrivateAccess = "true"))
+	TArray<TSubclassOf<AWeapon>> DefaultWeapons;
+
+	// Most weapons carried at once
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combat | Weapons", meta = (AllowPrivateAccess = "true"), meta = (ClampMin = "1"))
+	int32 MaxWeapons;
+
+	// Character mesh socket the equipped weapon is attached to
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combat | Weapons", meta = (AllowPrivateAccess = "true"))
+	FName WeaponHandSocketName;
+
+	UPROPERTY(VisibleInstanceOnly, Transient, Category = "Combat | Weapons", meta = (AllowPrivateAccess = "true"))
+	TArray<AWeapon*> WeaponPool;
+
+	int32 EquippedWeaponIndex;
+
+	// Character mesh's BarrelSocket, used while no weapon is equipped
+	FShooterSocketHandle BarrelSocket;
+
+	// Time the crosshair stays spread after a shot
+	float ShootTimeDuraiton;
+
+	// Left mouse button or right gamepad trigger pressed
+	bool bFireButtonPressed;
+
+	// Fire rate of rifle
+	float AutomaticFireRate;
+
+	// Single, automatic, shotgun or penetrating shots
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
+	EShooterFireMode FireMode;
+
+	// Pellets per shotgun shot
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat | Shotgun", meta = (AllowPrivateAccess = "true"), meta = (ClampMin = "8", ClampMax = "12"))
+	int32 PelletCount;
+
+	// Pellet cone half angle in degrees at a crosshair spread multiplier of 1
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat | Shotgun", meta = (AllowPrivateAccess = "true"))
+	float PelletSpreadAngle;
+
+	// Surfaces a penetrating round passes through after its first hit
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat | Penetration", meta = (AllowPrivateAccess = "true"))
+	int32 MaxPenetrations;
+
+	// Thickest surface a penetrating round passes through
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat | Penetration", meta = (AllowPrivateAccess = "true"))
+	float PenetrationDepth;
+
+	// Damage kept after each surface the round passes through
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat | Penetration", meta = (AllowPrivateAccess = "true"), meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float PenetrationDamageScale;
+
+	// Camera Y off set value
+	float CameraYOffset;
+
+	// Interp speed for switching camera sides
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Camera, meta = (AllowPrivateAccess = "true"))
+	float CameraSideInterpSpeed;
+		
+	bool bSlowMoActive;
+
+	// Time dilation scope of the active slow motion
+	int32 SlowMoScopeId;
+
+	// Actors within this radius of the character are slowed down by slow motion
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat | Slow Motion", meta = (AllowPrivateAccess = "true"))
+	float SlowMoRadius;
+
+	// Custom time dilation applied by slow motion
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat | Slow Motion", meta = (AllowPrivateAccess = "true"), meta = (ClampMin = "0.01", ClampMax = 1.0, UIMin = "0.01", UIMax = "1.0"))
+	float SlowMoDilation;
+
+
+	// Drone control duration
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Drone Ability", meta = (AllowPrivateAccess = "true"))
+	float DroneTime;
+
+	// Swap input and view target to the drone instead of possessing it, the drone is parked and reused afterwards
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Drone Ability", meta = (AllowPrivateAccess = "true"))
+	bool bFastPawnSwitch;
+
+	// Camera blend between character and drone when switching without possession
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Drone Ability", meta = (AllowPrivateAccess = "true"))
+	float DroneViewBlendTime;
+
+	bool bControllingDrone;
+
+	// Drone
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	TSubclassOf<APawn> Drone;
+	UPROPERTY(EditAnywhere, meta = (AllowPrivateAccess = "true"))
+	class ADrone* MyDrone;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	USoundCue* DashSound;
+	
+	// Sound effects for the time slow
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	USoundCue* SlowMoBeginSound;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	USoundCue* SlowMoEndSound;
+	
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat", meta = (AllowPrivateAccess = "True"))
+	USoundWave* SwitchModeSound;
+
+public:
+	/* Returns CameraBoom subobject */
+	FORCEINLINE USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
+	/* Returns FollowCamera subobject */
+	FORCEINLINE UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+
+	FORCEINLINE bool GetAiming() const { return bAiming; }
+
+	FORCEINLINE uint32 GetShotCounter() const { return ShotCounter; }
+
+	FORCEINLINE void SetUseProceduralRecoil(bool bUseProcedural) { bUseProceduralRecoil = bUseProcedural; }
+
+	FORCEINLINE TSubclassOf<APawn> GetDroneClass() const { return Drone; }
+
+	FORCEINLINE AWeapon* GetEquippedWeapon() const { return WeaponPool.IsValidIndex(EquippedWeaponIndex) ? WeaponPool[EquippedWeaponIndex] : nullptr; }
+
+	// Damage multiplier of the hitbox attached to BoneName, 1 for bones without a zone
+	float GetDamageMultiplierForBone(FName BoneName) const;
+
+	// BaseDamage scaled by the hit bone's damage zone when the hit actor is a shooter character, and by the hit surface's response
+	static float GetWeaponDamageForHit(const FHitResult& Hit, float BaseDamage, const class UShooterImpactResponseTable* ImpactResponses = nullptr);
+
+	// Applies point damage to the hit actor, scaled by the hit bone's damage zone when it is a shooter character
+	static void ApplyWeaponDamage(const FHitResult& Hit, float BaseDamage, const FVector& ShotDirection, AActor* DamageCauser, const class UShooterImpactResponseTable* ImpactResponses = nullptr);
+
+	// Impact response of the hit surface, FallbackParticle when there is no table
+	static void PlayWeaponImpact(UWorld* World, const FHitResult& Hit, const class UShooterImpactResponseTable* ImpactResponses, UParticleSystem* FallbackParticle);
+
+	// Applies damage that already includes damage zones, e.g. every pellet of a shot that hit the same actor
+	static void ApplyScaledWeaponDamage(const FHitResult& Hit, float Damage, const FVector& ShotDirection, AActor* DamageCauser);
+
+
+	UFUNCTION(BlueprintCallable)
+	float GetCrosshairSpreadMultiplier() const;
+
+	FORCEINLINE FOnCrosshairSpreadChanged& OnCrosshairSpreadChanged() { return CrosshairSpreadChangedEvent; }
+
+};
@@ -0,0 +1,149 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterCooldownComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
+
+// Sets default values for this component's properties
+UShooterCooldownComponent::UShooterCooldownComponent()
+{
+	// Only ticks while an expiry callback is pending
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	SetIsReplicatedByDefault(true);
+
+	NextCallbackTime = TNumericLimits<double>::Max();
+}
+
+void UShooterCooldownComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// Nobody else needs our ability timers
+	DOREPLIFETIME_CONDITION(UShooterCooldownComponent, Cooldowns, COND_OwnerOnly);
+}
+
+void UShooterCooldownComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const double Now = GetCooldownTime();
+	if (Now < NextCallbackTime)
+	{
+		return;
+	}
+
+	// Callbacks may start new cooldowns, so take the expired ones out first
+	TArray<FSimpleDelegate, TInlineAllocator<4>> Expired;
+	for (int32 Index = ExpiryCallbacks.Num() - 1; Index >= 0; --Index)
+	{
+		if (ExpiryCallbacks[Index].ExpiryTime <= Now)
+		{
+			Expired.Add(MoveTemp(ExpiryCallbacks[Index].Delegate));
+			ExpiryCallbacks.RemoveAtSwap(Index, 1, false);
+		}
+	}
+	UpdateNextCallbackTime();
+
+	for (FSimpleDelegate& Delegate : Expired)
+	{
+		Delegate.ExecuteIfBound();
+	}
+}
+
+void UShooterCooldownComponent::StartCooldown(FName Name, float Duration, FSimpleDelegate OnExpired)
+{
+	const AActor* Owner = GetOwner();
+	const float Dilation = Owner ? Owner->CustomTimeDilation : 1.f;
+	const double Now = GetCooldownTime();
+	const double ExpiryTime = Now + Duration / FMath::Max(Dilation, KINDA_SMALL_NUMBER);
+
+	// Reuse the entry with the same name, or any entry that already ran out
+	FShooterCooldown* Cooldown = Cooldowns.FindByPredicate([Name](const FShooterCooldown& Entry) { return Entry.Name == Name; });
+	if (Cooldown == nullptr)
+	{
+		Cooldown = Cooldowns.FindByPredicate([Now](const FShooterCooldown& Entry) { return Entry.ExpiryTime <= Now; });
+	}
+	if (Cooldown == nullptr)
+	{
+		Cooldown = &Cooldowns.AddDefaulted_GetRef();
+	}
+	Cooldown->Name = Name;
+	Cooldown->ExpiryTime = ExpiryTime;
+
+	ExpiryCallbacks.RemoveAllSwap([Name](const FExpiryCallback& Callback) { return Callback.Name == Name; });
+	if (OnExpired.IsBound())
+	{
+		ExpiryCallbacks.Add({ Name, ExpiryTime, MoveTemp(OnExpired) });
+	}
+	UpdateNextCallbackTime();
+}
+
+void UShooterCooldownComponent::ClearCooldown(FName Name)
+{
+	for (FShooterCooldown& Cooldown : Cooldowns)
+	{
+		if (Cooldown.Name == Name)
+		{
+			Cooldown.ExpiryTime = 0.0;
+		}
+	}
+	ExpiryCallbacks.RemoveAllSwap([Name](const FExpiryCallback& Callback) { return Callback.Name == Name; });
+	UpdateNextCallbackTime();
+}
+
+bool UShooterCooldownComponent::IsOnCooldown(FName Name) const
+{
+	return GetRemainingTime(Name) > 0.f;
+}
+
+float UShooterCooldownComponent::GetRemainingTime(FName Name) const
+{
+	const FShooterCooldown* Cooldown = Cooldowns.FindByPredicate([Name](const FShooterCooldown& Entry) { return Entry.Name == Name; });
+	return Cooldown ? static_cast<float>(FMath::Max(Cooldown->ExpiryTime - GetCooldownTime(), 0.0)) : 0.f;
+}
+
+void UShooterCooldownComponent::RescaleCooldowns(float Ratio)
+{
+	const double Now = GetCooldownTime();
+	for (FShooterCooldown& Cooldown : Cooldowns)
+	{
+		if (Cooldown.ExpiryTime > Now)
+		{
+			Cooldown.ExpiryTime = Now + (Cooldown.ExpiryTime - Now) * Ratio;
+		}
+	}
+	for (FExpiryCallback& Callback : ExpiryCallbacks)
+	{
+		if (Callback.ExpiryTime > Now)
+		{
+			Callback.ExpiryTime = Now + (Callback.ExpiryTime - Now) * Ratio;
+		}
+	}
+	UpdateNextCallbackTime();
+}
+
+double UShooterCooldownComponent::GetCooldownTime() const
+{
+	const UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return 0.0;
+	}
+	const AGameStateBase* GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+void UShooterCooldownComponent::UpdateNextCallbackTime()
+{
+	NextCallbackTime = TNumericLimits<double>::Max();
+	for (const FExpiryCallback& Callback : ExpiryCallbacks)
+	{
+		NextCallbackTime = FMath::Min(NextCallbackTime, Callback.ExpiryTime);
+	}
+	SetComponentTickEnabled(ExpiryCallbacks.Num() > 0);
+}
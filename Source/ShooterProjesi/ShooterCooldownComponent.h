@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ShooterCooldownComponent.generated.h"
+
+USTRUCT()
+struct FShooterCooldown
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FName Name;
+
+	// Server world time the cooldown ends at, double so short cooldowns stay exact on long running servers
+	UPROPERTY()
+	double ExpiryTime = 0.0;
+};
+
+/*
+	Cooldowns and short ability states of the owner, stored as expiry timestamps in one small array.
+	Checking a cooldown is a compare against the current time, nothing is registered with the timer manager.
+	Expired entries are reused by the next cooldown so the array only grows with the number of distinct names.
+	The array replicates to the owning client only. Expiry callbacks are local, the component ticks just while one is pending.
+*/
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class SHOOTERPROJESI_API UShooterCooldownComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UShooterCooldownComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// Starts or restarts Name for Duration of the owner's dilated time, OnExpired runs on this machine when it ends
+	void StartCooldown(FName Name, float Duration, FSimpleDelegate OnExpired = FSimpleDelegate());
+
+	// Ends Name now without running its expiry callback
+	void ClearCooldown(FName Name);
+
+	bool IsOnCooldown(FName Name) const;
+
+	// Seconds of world time until Name ends, 0 when it is not running
+	float GetRemainingTime(FName Name) const;
+
+	// Stretches every running cooldown by Ratio, called when the owner's CustomTimeDilation changes
+	void RescaleCooldowns(float Ratio);
+
+	// Time base of the expiry timestamps, synced with the server when a game state exists
+	double GetCooldownTime() const;
+
+private:
+	// Earliest pending callback, tick is turned off when none is left
+	void UpdateNextCallbackTime();
+
+	UPROPERTY(Replicated)
+	TArray<FShooterCooldown> Cooldowns;
+
+	struct FExpiryCallback
+	{
+		FName Name;
+		double ExpiryTime;
+		FSimpleDelegate Delegate;
+	};
+
+	TArray<FExpiryCallback> ExpiryCallbacks;
+
+	double NextCallbackTime;
+};
@@ -0,0 +1,197 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterDecalPoolSubsystem.h"
+#include "ShooterProjesi.h"
+#include "ShooterTaskScheduler.h"
+#include "Components/DecalComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarDecalCapacity(
+	TEXT("Shooter.Decals.Capacity"),
+	128,
+	TEXT("Impact decals per world, read when the pool is created"));
+
+static TAutoConsoleVariable<float> CVarDecalMergeRadius(
+	TEXT("Shooter.Decals.MergeRadius"),
+	6.f,
+	TEXT("Impacts closer than this to a live decal with the same material refresh it instead of adding a decal"));
+
+static TAutoConsoleVariable<float> CVarDecalFadeSeconds(
+	TEXT("Shooter.Decals.FadeSeconds"),
+	2.f,
+	TEXT("Fade out duration at the end of a decal's lifespan"));
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impact Decals Shown"), STAT_ShooterImpactDecals, STATGROUP_Shooter);
+
+UShooterDecalPoolSubsystem::UShooterDecalPoolSubsystem()
+{
+	PoolActor = nullptr;
+	HideTaskId = INDEX_NONE;
+	NumSpawned = 0;
+	NumMerged = 0;
+	NumRecycled = 0;
+}
+
+void UShooterDecalPoolSubsystem::Deinitialize()
+{
+	if (UShooterTaskSchedulerSubsystem* Scheduler = GetWorld()->GetSubsystem<UShooterTaskSchedulerSubsystem>())
+	{
+		Scheduler->UnregisterTask(HideTaskId);
+	}
+	HideTaskId = INDEX_NONE;
+	Decals.Reset();
+	Slots.Reset();
+	PoolActor = nullptr;
+
+	Super::Deinitialize();
+}
+
+bool UShooterDecalPoolSubsystem::CreatePool()
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr || World->GetNetMode() == NM_DedicatedServer || !World->IsGameWorld())
+	{
+		return false;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Name = TEXT("ImpactDecalPool");
+	SpawnParams.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+	SpawnParams.ObjectFlags |= RF_Transient;
+	PoolActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+	if (PoolActor == nullptr)
+	{
+		return false;
+	}
+
+	const int32 Capacity = FMath::Max(CVarDecalCapacity.GetValueOnGameThread(), 1);
+	Slots.SetNum(Capacity);
+	Decals.Reserve(Capacity);
+	for (int32 Slot = 0; Slot < Capacity; ++Slot)
+	{
+		UDecalComponent* Decal = NewObject<UDecalComponent>(PoolActor);
+		Decal->SetUsingAbsoluteLocation(true);
+		Decal->SetUsingAbsoluteRotation(true);
+		Decal->SetUsingAbsoluteScale(true);
+		Decal->SetVisibility(false);
+		Decal->RegisterComponent();
+		Decals.Add(Decal);
+	}
+
+	if (UShooterTaskSchedulerSubsystem* Scheduler = World->GetSubsystem<UShooterTaskSchedulerSubsystem>())
+	{
+		HideTaskId = Scheduler->RegisterTask(FName("HideFadedDecals"), EShooterTaskPriority::Low, 2.f,
+			FShooterScheduledTaskDelegate::CreateUObject(this, &UShooterDecalPoolSubsystem::HideFadedDecals));
+	}
+	return true;
+}
+
+void UShooterDecalPoolSubsystem::SpawnDecal(UMaterialInterface* Material, const FVector& Size, const FVector& Location, const FRotator& Rotation, float LifeSpan)
+{
+	if (Material == nullptr || (PoolActor == nullptr && !CreatePool()))
+	{
+		return;
+	}
+
+	// Bullets grouped on one spot keep one decal alive instead of stacking decals
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	const float MergeRadiusSquared = FMath::Square(CVarDecalMergeRadius.GetValueOnGameThread());
+	// A merge makes its decal the newest, so the slot to recycle is the least recently shown one, found in the same pass
+	int32 Slot = 0;
+	double OldestShownTime = TNumericLimits<double>::Max();
+	for (int32 Index = 0; Index < Slots.Num(); ++Index)
+	{
+		const FPooledDecal& PooledDecal = Slots[Index];
+		const bool bShown = PooledDecal.HiddenTime > WorldTime;
+		if (bShown && PooledDecal.Material == Material && FVector::DistSquared(PooledDecal.Location, Location) <= MergeRadiusSquared)
+		{
+			ShowDecal(Index, LifeSpan);
+			++NumMerged;
+			return;
+		}
+		// Free and faded slots go first
+		const double ShownTime = bShown ? PooledDecal.ShownTime : -1.0;
+		if (ShownTime < OldestShownTime)
+		{
+			OldestShownTime = ShownTime;
+			Slot = Index;
+		}
+	}
+
+	if (Slots[Slot].HiddenTime > WorldTime)
+	{
+		++NumRecycled;
+	}
+	++NumSpawned;
+
+	FPooledDecal& PooledDecal = Slots[Slot];
+	PooledDecal.Location = Location;
+	PooledDecal.Material = Material;
+	UDecalComponent* Decal = Decals[Slot];
+	Decal->SetWorldLocationAndRotation(Location, Rotation);
+	Decal->DecalSize = Size;
+	Decal->SetDecalMaterial(Material);
+	// Newer decals draw over older ones
+	Decal->SortOrder = static_cast<int32>(NumSpawned % MAX_int32);
+	ShowDecal(Slot, LifeSpan);
+}
+
+void UShooterDecalPoolSubsystem::ShowDecal(int32 Slot, float LifeSpan)
+{
+	const float FadeSeconds = FMath::Max(CVarDecalFadeSeconds.GetValueOnGameThread(), 0.f);
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	Slots[Slot].ShownTime = WorldTime;
+	Slots[Slot].HiddenTime = WorldTime + LifeSpan + FadeSeconds;
+
+	UDecalComponent* Decal = Decals[Slot];
+	Decal->SetFadeOut(LifeSpan, FadeSeconds, false);
+	// SetFadeOut also starts a timer destroying the component, the pool hides it instead
+	Decal->SetLifeSpan(0.f);
+	Decal->SetVisibility(true);
+	Decal->MarkRenderStateDirty();
+}
+
+void UShooterDecalPoolSubsystem::HideFadedDecals(float DeltaTime)
+{
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	int32 NumShown = 0;
+	for (int32 Slot = 0; Slot < Slots.Num(); ++Slot)
+	{
+		FPooledDecal& PooledDecal = Slots[Slot];
+		if (PooledDecal.HiddenTime == 0.0)
+		{
+			continue;
+		}
+		if (PooledDecal.HiddenTime <= WorldTime)
+		{
+			Decals[Slot]->SetVisibility(false);
+			PooledDecal.HiddenTime = 0.0;
+			PooledDecal.Material = nullptr;
+			continue;
+		}
+		++NumShown;
+	}
+	SET_DWORD_STAT(STAT_ShooterImpactDecals, NumShown);
+}
+
+void UShooterDecalPoolSubsystem::LogStats() const
+{
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	const int32 NumShown = Slots.FilterByPredicate([WorldTime](const FPooledDecal& PooledDecal) { return PooledDecal.HiddenTime > WorldTime; }).Num();
+	UE_LOG(LogShooter, Display, TEXT("Impact decals: %d of %d shown, %llu spawned, %llu merged, %llu recycled before fading"),
+		NumShown, Slots.Num(), NumSpawned, NumMerged, NumRecycled);
+}
+
+static FAutoConsoleCommandWithWorld DecalStatsCommand(
+	TEXT("Shooter.Decals.Stats"),
+	TEXT("Logs impact decal pool usage"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShooterDecalPoolSubsystem* DecalPool = World ? World->GetSubsystem<UShooterDecalPoolSubsystem>() : nullptr)
+		{
+			DecalPool->LogStats();
+		}
+	}));
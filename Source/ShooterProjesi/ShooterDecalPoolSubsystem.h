@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterDecalPoolSubsystem.generated.h"
+
+class UDecalComponent;
+class UMaterialInterface;
+
+/*
+	Impact decals of a world, a fixed pool of Shooter.Decals.Capacity decal components made on the first impact.
+	A new decal takes a free slot or the least recently shown one, and an impact within Shooter.Decals.MergeRadius of a live
+	decal with the same material refreshes that decal instead of adding one. Decals fade out at the end of their lifespan and
+	are hidden once faded, so decal memory and draw cost stay fixed however long the world runs. Nothing is spawned on dedicated servers.
+*/
+UCLASS()
+class SHOOTERPROJESI_API UShooterDecalPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UShooterDecalPoolSubsystem();
+
+	virtual void Deinitialize() override;
+
+	// Shows Material at Location for LifeSpan seconds, then fades it out
+	void SpawnDecal(UMaterialInterface* Material, const FVector& Size, const FVector& Location, const FRotator& Rotation, float LifeSpan);
+
+	void LogStats() const;
+
+private:
+	struct FPooledDecal
+	{
+		// World time the decal has faded out at, 0 for free slots
+		double HiddenTime = 0.0;
+
+		// World time the decal was last shown or refreshed by a merge, the oldest slot is recycled first
+		double ShownTime = 0.0;
+		FVector Location = FVector::ZeroVector;
+		UMaterialInterface* Material = nullptr;
+	};
+
+	bool CreatePool();
+
+	// Shows the decal in Slot and restarts its fade
+	void ShowDecal(int32 Slot, float LifeSpan);
+
+	// Scheduled, hides the decals that have faded out
+	void HideFadedDecals(float DeltaTime);
+
+	// Owns the decal components, the components keep absolute transforms
+	UPROPERTY(Transient)
+	AActor* PoolActor;
+
+	UPROPERTY(Transient)
+	TArray<UDecalComponent*> Decals;
+
+	TArray<FPooledDecal> Slots;
+
+	int32 HideTaskId;
+
+	uint64 NumSpawned;
+	uint64 NumMerged;
+	uint64 NumRecycled;
+};
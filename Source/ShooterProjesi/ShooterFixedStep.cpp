@@ -0,0 +1,174 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterFixedStep.h"
+#include "ShooterProjesi.h"
+#include "ShooterHitchDetector.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarFixedStepHz(
+	TEXT("Shooter.FixedStep.Hz"),
+	60.f,
+	TEXT("Gameplay simulation steps per second, 0 steps once per frame with the frame's delta time"));
+
+static TAutoConsoleVariable<int32> CVarFixedStepMaxStepsPerFrame(
+	TEXT("Shooter.FixedStep.MaxStepsPerFrame"),
+	4,
+	TEXT("Most fixed steps run in one frame, time beyond them is dropped so a hitch can't make the next frames slower"));
+
+DECLARE_CYCLE_STAT(TEXT("Fixed Steps"), STAT_ShooterFixedSteps, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Fixed Steps Per Frame"), STAT_ShooterFixedStepsPerFrame, STATGROUP_Shooter);
+
+UShooterFixedStepSubsystem::UShooterFixedStepSubsystem()
+{
+	NextStepId = 0;
+	Accumulator = 0.f;
+	InterpolationAlpha = 1.f;
+	bRunningSteps = false;
+	bHasRemovedSteps = false;
+	NumFrames = 0;
+	NumSteps = 0;
+	NumClampedFrames = 0;
+}
+
+void UShooterFixedStepSubsystem::Deinitialize()
+{
+	Steps.Reset();
+	OnPreSteps.Clear();
+
+	Super::Deinitialize();
+}
+
+TStatId UShooterFixedStepSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterFixedStepSubsystem, STATGROUP_Tickables);
+}
+
+int32 UShooterFixedStepSubsystem::RegisterStep(FName Name, FShooterFixedStepDelegate Delegate, const AActor* Owner)
+{
+	FFixedStep& Step = Steps.AddDefaulted_GetRef();
+	Step.Id = NextStepId++;
+	Step.Name = Name;
+	Step.Delegate = MoveTemp(Delegate);
+	Step.Owner = Owner;
+	Step.bHasOwner = Owner != nullptr;
+	return Step.Id;
+}
+
+void UShooterFixedStepSubsystem::UnregisterStep(int32 StepId)
+{
+	const int32 StepIndex = Steps.IndexOfByPredicate([StepId](const FFixedStep& Step) { return Step.Id == StepId; });
+	if (StepIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (bRunningSteps)
+	{
+		Steps[StepIndex].Delegate.Unbind();
+		bHasRemovedSteps = true;
+	}
+	else
+	{
+		// Keep registration order
+		Steps.RemoveAt(StepIndex);
+	}
+}
+
+bool UShooterFixedStepSubsystem::IsFixedStepEnabled() const
+{
+	return CVarFixedStepHz.GetValueOnGameThread() > 0.f;
+}
+
+void UShooterFixedStepSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_ShooterFixedSteps);
+
+	++NumFrames;
+	OnPreSteps.Broadcast();
+
+	const float Hz = CVarFixedStepHz.GetValueOnGameThread();
+	if (Hz <= 0.f)
+	{
+		Accumulator = 0.f;
+		InterpolationAlpha = 1.f;
+		RunSteps(DeltaTime);
+		SET_DWORD_STAT(STAT_ShooterFixedStepsPerFrame, 1);
+		return;
+	}
+
+	const float StepTime = 1.f / Hz;
+	const int32 MaxStepsPerFrame = FMath::Max(CVarFixedStepMaxStepsPerFrame.GetValueOnGameThread(), 1);
+	Accumulator += DeltaTime;
+
+	int32 NumFrameSteps = 0;
+	while (Accumulator >= StepTime && NumFrameSteps < MaxStepsPerFrame)
+	{
+		RunSteps(StepTime);
+		Accumulator -= StepTime;
+		++NumFrameSteps;
+	}
+	if (Accumulator >= StepTime)
+	{
+		++NumClampedFrames;
+		UE_LOG(LogShooter, Verbose, TEXT("Fixed step dropped %.3f s after %d steps"), Accumulator - FMath::Fmod(Accumulator, StepTime), NumFrameSteps);
+		Accumulator = FMath::Fmod(Accumulator, StepTime);
+	}
+	InterpolationAlpha = Accumulator / StepTime;
+	SET_DWORD_STAT(STAT_ShooterFixedStepsPerFrame, NumFrameSteps);
+	FShooterHitchDetector::Get().AddCounter(TEXT("FixedSteps"), NumFrameSteps);
+}
+
+void UShooterFixedStepSubsystem::RunSteps(float StepTime)
+{
+	++NumSteps;
+	bRunningSteps = true;
+	// Steps registered from inside a step start with the next one
+	const int32 NumRegistered = Steps.Num();
+	for (int32 StepIndex = 0; StepIndex < NumRegistered; ++StepIndex)
+	{
+		FFixedStep& Step = Steps[StepIndex];
+		const AActor* Owner = Step.Owner.Get();
+		if (Step.bHasOwner && Owner == nullptr)
+		{
+			Step.Delegate.Unbind(); // Owner is gone without unregistering
+			bHasRemovedSteps = true;
+			continue;
+		}
+
+		// The step may register new steps and reallocate Steps, copy the delegate first
+		const FShooterFixedStepDelegate Delegate = Step.Delegate;
+		Delegate.ExecuteIfBound(Owner ? StepTime * Owner->CustomTimeDilation : StepTime);
+	}
+	bRunningSteps = false;
+
+	if (bHasRemovedSteps)
+	{
+		Steps.RemoveAll([](const FFixedStep& Step) { return !Step.Delegate.IsBound(); });
+		bHasRemovedSteps = false;
+	}
+}
+
+void UShooterFixedStepSubsystem::LogStats() const
+{
+	UE_LOG(LogShooter, Display, TEXT("Fixed step: %d steps registered at %.1f Hz, %llu steps over %llu frames, %llu frames dropped time"),
+		Steps.Num(), CVarFixedStepHz.GetValueOnGameThread(), NumSteps, NumFrames, NumClampedFrames);
+	for (const FFixedStep& Step : Steps)
+	{
+		UE_LOG(LogShooter, Display, TEXT("  %s"), *Step.Name.ToString());
+	}
+}
+
+static FAutoConsoleCommandWithWorld FixedStepStatsCommand(
+	TEXT("Shooter.FixedStep.Stats"),
+	TEXT("Logs registered fixed steps and how many steps ran per frame"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShooterFixedStepSubsystem* FixedStep = World ? World->GetSubsystem<UShooterFixedStepSubsystem>() : nullptr)
+		{
+			FixedStep->LogStats();
+		}
+	}));
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterFixedStep.generated.h"
+
+// Receives the fixed step length, scaled by the owner's CustomTimeDilation
+DECLARE_DELEGATE_OneParam(FShooterFixedStepDelegate, float /*StepTime*/);
+
+/*
+	Fixed timestep gameplay simulation. Frame time is collected in an accumulator and registered steps run once for every
+	1 / Shooter.FixedStep.Hz seconds in it, so their results don't depend on frame rate or hitches. Visuals read
+	GetInterpolationAlpha to blend between the last two steps. Shooter.FixedStep.Hz 0 runs every step once per frame with
+	the frame's delta time instead.
+*/
+UCLASS()
+class SHOOTERPROJESI_API UShooterFixedStepSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UShooterFixedStepSubsystem();
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/*
+		Registers a step, returns its id for UnregisterStep. Steps run in registration order
+		@param Owner Its CustomTimeDilation scales the step time like an actor tick
+	*/
+	int32 RegisterStep(FName Name, FShooterFixedStepDelegate Delegate, const AActor* Owner = nullptr);
+
+	// Safe to call from inside a step
+	void UnregisterStep(int32 StepId);
+
+	// How far the frame is between the previous and the last step, 1 when not running fixed steps
+	FORCEINLINE float GetInterpolationAlpha() const { return InterpolationAlpha; }
+
+	bool IsFixedStepEnabled() const;
+
+	// Broadcast at the start of every Tick before any step runs, after the player controllers processed this frame's input
+	FSimpleMulticastDelegate OnPreSteps;
+
+	void LogStats() const;
+
+private:
+	struct FFixedStep
+	{
+		int32 Id = INDEX_NONE;
+		FName Name;
+		FShooterFixedStepDelegate Delegate;
+		TWeakObjectPtr<const AActor> Owner;
+		bool bHasOwner = false;
+	};
+
+	void RunSteps(float StepTime);
+
+	TArray<FFixedStep> Steps;
+
+	int32 NextStepId;
+
+	float Accumulator;
+	float InterpolationAlpha;
+
+	// Unregistered while steps were running, removed after the frame
+	bool bRunningSteps;
+	bool bHasRemovedSteps;
+
+	uint64 NumFrames;
+	uint64 NumSteps;
+	// Frames that hit Shooter.FixedStep.MaxStepsPerFrame and dropped the rest of their time
+	uint64 NumClampedFrames;
+};
@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterHUD.h"
+#include "SShooterCrosshair.h"
+#include "ShooterCharacter.h"
+#include "ShooterPickupWidget.h"
+#include "Item.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/PlayerController.h"
+#include "Widgets/SInvalidationPanel.h"
+
+AShooterHUD::AShooterHUD()
+{
+	bDrawNativeCrosshair = true;
+	CrosshairElementSize = FVector2D(64.f, 64.f);
+	CrosshairSpreadOffset = 16.f;
+	PickupWidgetPoolSize = 4;
+
+	// Only ticks while pickup widgets are shown
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
+void AShooterHUD::BeginPlay()
+{
+	Super::BeginPlay();
+
+	CreatePickupWidgetPool();
+
+	ULocalPlayer* LocalPlayer = PlayerOwner ? PlayerOwner->GetLocalPlayer() : nullptr;
+	if (!bDrawNativeCrosshair || LocalPlayer == nullptr || GEngine == nullptr || GEngine->GameViewport == nullptr)
+	{
+		return;
+	}
+
+	// The panel caches the crosshair's draw elements, they are only rebuilt when the spread invalidates it
+	CrosshairRoot = SNew(SInvalidationPanel)
+		.Visibility(EVisibility::Collapsed)
+		[
+			SAssignNew(CrosshairWidget, SShooterCrosshair)
+			.TopBrush(&CrosshairTop)
+			.BottomBrush(&CrosshairBottom)
+			.LeftBrush(&CrosshairLeft)
+			.RightBrush(&CrosshairRight)
+			.ElementSize(CrosshairElementSize)
+			.SpreadOffset(CrosshairSpreadOffset)
+		];
+	GEngine->GameViewport->AddViewportWidgetForPlayer(LocalPlayer, CrosshairRoot.ToSharedRef(), 0);
+
+	NewPawnHandle = PlayerOwner->GetOnNewPawnNotifier().AddUObject(this, &AShooterHUD::OnPawnChanged);
+	OnPawnChanged(PlayerOwner->GetPawn());
+}
+
+void AShooterHUD::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	OnPawnChanged(nullptr);
+
+	for (UShooterPickupWidget* PickupWidget : PickupWidgetPool)
+	{
+		PickupWidget->RemoveFromParent();
+	}
+	PickupWidgetPool.Reset();
+	PickupWidgetItems.Reset();
+	if (PlayerOwner)
+	{
+		PlayerOwner->GetOnNewPawnNotifier().Remove(NewPawnHandle);
+	}
+
+	ULocalPlayer* LocalPlayer = PlayerOwner ? PlayerOwner->GetLocalPlayer() : nullptr;
+	if (CrosshairRoot.IsValid() && LocalPlayer && GEngine && GEngine->GameViewport)
+	{
+		GEngine->GameViewport->RemoveViewportWidgetForPlayer(LocalPlayer, CrosshairRoot.ToSharedRef());
+	}
+	CrosshairRoot.Reset();
+	CrosshairWidget.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShooterHUD::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UpdatePickupWidgetPositions();
+}
+
+void AShooterHUD::CreatePickupWidgetPool()
+{
+	if (PickupWidgetClass == nullptr || PlayerOwner == nullptr || !PlayerOwner->IsLocalController())
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < PickupWidgetPoolSize; ++Index)
+	{
+		UShooterPickupWidget* PickupWidget = CreateWidget<UShooterPickupWidget>(PlayerOwner, PickupWidgetClass);
+		if (PickupWidget == nullptr)
+		{
+			break;
+		}
+		PickupWidget->SetAlignmentInViewport(FVector2D(0.5f, 1.f));
+		PickupWidget->SetVisibility(ESlateVisibility::Collapsed);
+		PickupWidget->AddToPlayerScreen();
+		PickupWidgetPool.Add(PickupWidget);
+	}
+	PickupWidgetItems.SetNum(PickupWidgetPool.Num());
+}
+
+void AShooterHUD::SetFocusedItems(const TArray<AItem*>& Items)
+{
+	const int32 NumShown = FMath::Min(Items.Num(), PickupWidgetPool.Num());
+
+	// Free widgets whose item lost focus, widgets keeping their item are not touched
+	for (int32 Slot = 0; Slot < PickupWidgetPool.Num(); ++Slot)
+	{
+		AItem* SlotItem = PickupWidgetItems[Slot].Get();
+		const int32 FocusIndex = SlotItem ? Items.Find(SlotItem) : INDEX_NONE;
+		if (FocusIndex == INDEX_NONE || FocusIndex >= NumShown)
+		{
+			if (!PickupWidgetItems[Slot].IsExplicitlyNull())
+			{
+				PickupWidgetPool[Slot]->SetVisibility(ESlateVisibility::Collapsed);
+			}
+			PickupWidgetItems[Slot].Reset();
+		}
+	}
+
+	for (int32 FocusIndex = 0; FocusIndex < NumShown; ++FocusIndex)
+	{
+		AItem* Item = Items[FocusIndex];
+		if (Item == nullptr || PickupWidgetItems.Contains(Item))
+		{
+			continue;
+		}
+		const int32 FreeSlot = PickupWidgetItems.IndexOfByPredicate([](const TWeakObjectPtr<AItem>& SlotItem) { return SlotItem.IsExplicitlyNull(); });
+		if (FreeSlot == INDEX_NONE)
+		{
+			break;
+		}
+		PickupWidgetItems[FreeSlot] = Item;
+		PickupWidgetPool[FreeSlot]->SetItem(Item);
+	}
+
+	UpdatePickupWidgetPositions();
+}
+
+void AShooterHUD::UpdatePickupWidgetPositions()
+{
+	bool bAnyAssigned = false;
+	for (int32 Slot = 0; Slot < PickupWidgetPool.Num(); ++Slot)
+	{
+		if (PickupWidgetItems[Slot].IsExplicitlyNull())
+		{
+			continue;
+		}
+		UShooterPickupWidget* PickupWidget = PickupWidgetPool[Slot];
+		const AItem* Item = PickupWidgetItems[Slot].Get();
+		if (Item == nullptr)
+		{
+			// Item was destroyed while in focus
+			PickupWidget->SetVisibility(ESlateVisibility::Collapsed);
+			PickupWidgetItems[Slot].Reset();
+			continue;
+		}
+		bAnyAssigned = true;
+
+		FVector2D ScreenLocation;
+		if (PlayerOwner->ProjectWorldLocationToScreen(Item->GetPickupWidgetLocation(), ScreenLocation, true))
+		{
+			PickupWidget->SetPositionInViewport(ScreenLocation);
+			PickupWidget->SetVisibility(ESlateVisibility::HitTestInvisible);
+		}
+		else
+		{
+			PickupWidget->SetVisibility(ESlateVisibility::Collapsed);
+		}
+	}
+	SetActorTickEnabled(bAnyAssigned);
+}
+
+void AShooterHUD::OnPawnChanged(APawn* NewPawn)
+{
+	if (AShooterCharacter* OldCharacter = CrosshairCharacter.Get())
+	{
+		OldCharacter->OnCrosshairSpreadChanged().Remove(CrosshairSpreadHandle);
+	}
+	CrosshairSpreadHandle.Reset();
+	CrosshairCharacter = Cast<AShooterCharacter>(NewPawn);
+
+	// Focused items are reported again by the new pawn
+	SetFocusedItems(TArray<AItem*>());
+
+	if (!CrosshairRoot.IsValid())
+	{
+		return;
+	}
+
+	// Drone and spectator pawns have no crosshair
+	AShooterCharacter* NewCharacter = CrosshairCharacter.Get();
+	CrosshairRoot->SetVisibility(NewCharacter ? EVisibility::HitTestInvisible : EVisibility::Collapsed);
+	if (NewCharacter)
+	{
+		CrosshairSpreadHandle = NewCharacter->OnCrosshairSpreadChanged().AddUObject(this, &AShooterHUD::OnCrosshairSpreadChanged);
+		CrosshairWidget->SetSpreadMultiplier(NewCharacter->GetCrosshairSpreadMultiplier());
+	}
+}
+
+void AShooterHUD::OnCrosshairSpreadChanged(float SpreadMultiplier)
+{
+	if (CrosshairWidget.IsValid())
+	{
+		CrosshairWidget->SetSpreadMultiplier(SpreadMultiplier);
+	}
+}
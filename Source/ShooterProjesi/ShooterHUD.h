@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/HUD.h"
+#include "Styling/SlateBrush.h"
+#include "ShooterHUD.generated.h"
+
+class AShooterCharacter;
+class AItem;
+class SShooterCrosshair;
+class UShooterPickupWidget;
+
+/*
+	Player HUD. Draws the crosshair natively with Slate, the crosshair listens to the controlled character's
+	spread change event instead of polling it every frame and is hidden while the player is not a shooter character.
+	Owns a small pool of screen space pickup widgets that are handed to the items in focus, so widget count does not
+	grow with the number of items in the level.
+*/
+UCLASS()
+class SHOOTERPROJESI_API AShooterHUD : public AHUD
+{
+	GENERATED_BODY()
+
+public:
+	AShooterHUD();
+
+	virtual void Tick(float DeltaTime) override;
+
+	// Shows pickup widgets over Items, ordered by priority. Items beyond the pool size get no widget
+	void SetFocusedItems(const TArray<AItem*>& Items);
+
+	// For pawn switches that keep the possessed pawn, e.g. flying the drone without possessing it
+	FORCEINLINE void SetActivePawn(APawn* ActivePawn) { OnPawnChanged(ActivePawn); }
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	void CreatePickupWidgetPool();
+
+	// Keeps assigned pickup widgets over their items, hides the ones whose item is off screen
+	void UpdatePickupWidgetPositions();
+
+	void OnPawnChanged(APawn* NewPawn);
+
+	void OnCrosshairSpreadChanged(float SpreadMultiplier);
+
+	// Turn off when the crosshair is still drawn by a widget blueprint
+	UPROPERTY(EditDefaultsOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	bool bDrawNativeCrosshair;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	FSlateBrush CrosshairTop;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	FSlateBrush CrosshairBottom;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	FSlateBrush CrosshairLeft;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	FSlateBrush CrosshairRight;
+
+	// Size of each crosshair element
+	UPROPERTY(EditDefaultsOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	FVector2D CrosshairElementSize;
+
+	// Distance an element moves from the center per unit of spread multiplier
+	UPROPERTY(EditDefaultsOnly, Category = "Crosshairs", meta = (AllowPrivateAccess = "true"))
+	float CrosshairSpreadOffset;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Pickup", meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<UShooterPickupWidget> PickupWidgetClass;
+
+	// Most pickup widgets on screen at once
+	UPROPERTY(EditDefaultsOnly, Category = "Pickup", meta = (AllowPrivateAccess = "true"), meta = (ClampMin = "1"))
+	int32 PickupWidgetPoolSize;
+
+	UPROPERTY(Transient)
+	TArray<UShooterPickupWidget*> PickupWidgetPool;
+
+	// Item each pooled widget is showing, null for free widgets
+	TArray<TWeakObjectPtr<AItem>> PickupWidgetItems;
+
+	TSharedPtr<SShooterCrosshair> CrosshairWidget;
+
+	// Invalidation panel around the crosshair, added to the owning player's viewport
+	TSharedPtr<SWidget> CrosshairRoot;
+
+	TWeakObjectPtr<AShooterCharacter> CrosshairCharacter;
+
+	FDelegateHandle CrosshairSpreadHandle;
+
+	FDelegateHandle NewPawnHandle;
+};
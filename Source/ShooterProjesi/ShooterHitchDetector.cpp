@@ -0,0 +1,231 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterHitchDetector.h"
+#include "ShooterProjesi.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/IConsoleManager.h"
+#include "Engine/Engine.h"
+#include "RenderCore.h"
+
+static TAutoConsoleVariable<int32> CVarHitchEnabled(
+	TEXT("Shooter.Hitch.Enabled"),
+	1,
+	TEXT("Watch game thread frame time and dump the last frames when one goes over Shooter.Hitch.ThresholdMs"));
+
+static TAutoConsoleVariable<float> CVarHitchThresholdMs(
+	TEXT("Shooter.Hitch.ThresholdMs"),
+	50.f,
+	TEXT("Game thread time of a frame in milliseconds counted as a hitch, render thread and GPU waits are not included"));
+
+static TAutoConsoleVariable<int32> CVarHitchFrames(
+	TEXT("Shooter.Hitch.Frames"),
+	120,
+	TEXT("Frames kept for a hitch dump, read when the detector starts"));
+
+static TAutoConsoleVariable<float> CVarHitchMinSecondsBetweenDumps(
+	TEXT("Shooter.Hitch.MinSecondsBetweenDumps"),
+	5.f,
+	TEXT("Hitches right after a dump are in the dumped frames already, don't write a file for each"));
+
+// In the editor only play in editor counts, asset loads, shader compiles and map opens are not game hitches
+static bool IsGameRunning()
+{
+	if (!GIsEditor)
+	{
+		return true;
+	}
+	if (GEngine)
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if (Context.WorldType == EWorldType::PIE)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+FShooterHitchDetector& FShooterHitchDetector::Get()
+{
+	static FShooterHitchDetector Detector;
+	return Detector;
+}
+
+FShooterHitchDetector::FShooterHitchDetector()
+	: CurrentFrame(0)
+	, NumRecordedFrames(0)
+	, LastDumpTime(0.0)
+	, bDumpRequested(false)
+{
+}
+
+void FShooterHitchDetector::Start()
+{
+	if (EndFrameHandle.IsValid())
+	{
+		return;
+	}
+	Frames.SetNum(FMath::Max(CVarHitchFrames.GetValueOnGameThread(), 2));
+	CurrentFrame = 0;
+	NumRecordedFrames = 0;
+	Frames[CurrentFrame].StartTime = FPlatformTime::Seconds();
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FShooterHitchDetector::OnEndFrame);
+}
+
+void FShooterHitchDetector::Stop()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	EndFrameHandle.Reset();
+	Frames.Empty();
+}
+
+FShooterHitchDetector::FHitchFrame& FShooterHitchDetector::GetCurrentFrame()
+{
+	return Frames[CurrentFrame];
+}
+
+void FShooterHitchDetector::RecordEvent(const TCHAR* Name)
+{
+	if (!IsInGameThread() || Frames.Num() == 0)
+	{
+		return;
+	}
+	FHitchFrame& Frame = GetCurrentFrame();
+	FHitchEntry& Entry = Frame.Entries.AddDefaulted_GetRef();
+	Entry.Name = Name;
+	Entry.Time = FPlatformTime::Seconds() - Frame.StartTime;
+}
+
+void FShooterHitchDetector::RecordTiming(const TCHAR* Name, double StartTime, double EndTime)
+{
+	if (!IsInGameThread() || Frames.Num() == 0)
+	{
+		return;
+	}
+	FHitchFrame& Frame = GetCurrentFrame();
+	FHitchEntry& Entry = Frame.Entries.AddDefaulted_GetRef();
+	Entry.Name = Name;
+	Entry.Time = StartTime - Frame.StartTime;
+	Entry.DurationMs = (EndTime - StartTime) * 1000.0;
+}
+
+void FShooterHitchDetector::AddCounter(const TCHAR* Name, int64 Value)
+{
+	if (!IsInGameThread() || Frames.Num() == 0)
+	{
+		return;
+	}
+	FHitchFrame& Frame = GetCurrentFrame();
+	if (FHitchCounter* Counter = Frame.Counters.FindByPredicate([Name](const FHitchCounter& Entry) { return Entry.Name == Name; }))
+	{
+		Counter->Value += Value;
+		return;
+	}
+	Frame.Counters.Add({ Name, Value });
+}
+
+void FShooterHitchDetector::OnEndFrame()
+{
+	const double Now = FPlatformTime::Seconds();
+	FHitchFrame& Frame = GetCurrentFrame();
+	Frame.FrameNumber = GFrameCounter;
+	Frame.FrameMs = (Now - Frame.StartTime) * 1000.0;
+	Frame.GameThreadMs = -1.0;
+	Frame.RenderThreadMs = -1.0;
+
+	// Thread times are from the last completed frame, so the previous frame is the one tested for a hitch
+	FHitchFrame* PreviousFrame = NumRecordedFrames > 0 ? &Frames[(CurrentFrame + Frames.Num() - 1) % Frames.Num()] : nullptr;
+	if (PreviousFrame)
+	{
+		PreviousFrame->GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+		PreviousFrame->RenderThreadMs = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+	}
+	NumRecordedFrames = FMath::Min(NumRecordedFrames + 1, Frames.Num());
+
+	// Game thread time leaves out waits for the render thread and GPU
+	const bool bHitch = CVarHitchEnabled.GetValueOnGameThread() != 0
+		&& PreviousFrame
+		&& PreviousFrame->GameThreadMs > CVarHitchThresholdMs.GetValueOnGameThread()
+		&& Now - LastDumpTime > CVarHitchMinSecondsBetweenDumps.GetValueOnGameThread()
+		&& IsGameRunning();
+	if (bHitch)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Hitch: frame %llu game thread took %.1f ms"), PreviousFrame->FrameNumber, PreviousFrame->GameThreadMs);
+		WriteDump(TEXT("Hitch"));
+	}
+	else if (bDumpRequested)
+	{
+		WriteDump(TEXT("Manual"));
+	}
+	bDumpRequested = false;
+
+	// Reuse the oldest frame, its arrays keep their memory
+	CurrentFrame = (CurrentFrame + 1) % Frames.Num();
+	FHitchFrame& NextFrame = GetCurrentFrame();
+	NextFrame.Entries.Reset();
+	NextFrame.Counters.Reset();
+	NextFrame.StartTime = Now;
+}
+
+void FShooterHitchDetector::RequestDump()
+{
+	bDumpRequested = true;
+}
+
+void FShooterHitchDetector::WriteDump(const TCHAR* Reason)
+{
+	LastDumpTime = FPlatformTime::Seconds();
+
+	FString Text = FString::Printf(TEXT("%s, last %d frames, threshold %.1f ms") LINE_TERMINATOR, Reason, NumRecordedFrames, CVarHitchThresholdMs.GetValueOnGameThread());
+	// Oldest first, ending with the frame that just finished
+	const int32 FirstFrame = CurrentFrame - NumRecordedFrames + 1 + Frames.Num();
+	for (int32 Offset = 0; Offset < NumRecordedFrames; ++Offset)
+	{
+		const FHitchFrame& Frame = Frames[(FirstFrame + Offset) % Frames.Num()];
+		if (Frame.GameThreadMs < 0.0)
+		{
+			// Just finished, its thread times come with the next frame
+			Text += FString::Printf(TEXT("Frame %llu: %.2f ms, thread times pending") LINE_TERMINATOR, Frame.FrameNumber, Frame.FrameMs);
+		}
+		else
+		{
+			Text += FString::Printf(TEXT("Frame %llu: %.2f ms, game thread %.2f ms, render thread %.2f ms") LINE_TERMINATOR,
+				Frame.FrameNumber, Frame.FrameMs, Frame.GameThreadMs, Frame.RenderThreadMs);
+		}
+		for (const FHitchEntry& Entry : Frame.Entries)
+		{
+			if (Entry.DurationMs < 0.0)
+			{
+				Text += FString::Printf(TEXT("  %8.3f ms  event %s") LINE_TERMINATOR, Entry.Time * 1000.0, Entry.Name);
+			}
+			else
+			{
+				Text += FString::Printf(TEXT("  %8.3f ms  scope %s took %.3f ms") LINE_TERMINATOR, Entry.Time * 1000.0, Entry.Name, Entry.DurationMs);
+			}
+		}
+		for (const FHitchCounter& Counter : Frame.Counters)
+		{
+			Text += FString::Printf(TEXT("  counter %s = %lld") LINE_TERMINATOR, Counter.Name, Counter.Value);
+		}
+	}
+
+	const FString Path = FPaths::ProfilingDir() / TEXT("Hitches") / FString::Printf(TEXT("%s_%s_%llu.txt"), Reason, *FDateTime::Now().ToString(), GFrameCounter);
+	if (FFileHelper::SaveStringToFile(Text, *Path))
+	{
+		UE_LOG(LogShooter, Display, TEXT("Hitch frames written to %s"), *Path);
+	}
+}
+
+static FAutoConsoleCommand HitchDumpCommand(
+	TEXT("Shooter.Hitch.Dump"),
+	TEXT("Writes the buffered hitch detector frames to Saved/Profiling/Hitches at the end of the frame"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FShooterHitchDetector::Get().RequestDump();
+	}));
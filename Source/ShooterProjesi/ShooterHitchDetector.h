@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+	Always on game thread hitch detector, started by the game module outside commandlets. Keeps the gameplay events, scoped timings
+	and counters of the last Shooter.Hitch.Frames frames in a ring buffer, and when a frame's game thread time is over
+	Shooter.Hitch.ThresholdMs writes them to Saved/Profiling/Hitches so intermittent spikes can be read from headless runs.
+	In the editor hitches are only dumped during PIE.
+	Names must be string literals, they are stored as pointers. Calls from other threads are ignored.
+*/
+class SHOOTERPROJESI_API FShooterHitchDetector
+{
+public:
+	static FShooterHitchDetector& Get();
+
+	void Start();
+
+	void Stop();
+
+	// Something happened this frame, e.g. an ability was activated
+	void RecordEvent(const TCHAR* Name);
+
+	void RecordTiming(const TCHAR* Name, double StartTime, double EndTime);
+
+	// Adds Value to the counter Name of this frame
+	void AddCounter(const TCHAR* Name, int64 Value);
+
+	// Writes the buffered frames to a file at the end of this frame
+	void RequestDump();
+
+private:
+	FShooterHitchDetector();
+
+	void OnEndFrame();
+
+	// Reason goes into the file name
+	void WriteDump(const TCHAR* Reason);
+
+	struct FHitchEntry
+	{
+		const TCHAR* Name = nullptr;
+		// Seconds since the frame started
+		double Time = 0.0;
+		// Scoped timings only, events have a negative duration
+		double DurationMs = -1.0;
+	};
+
+	struct FHitchCounter
+	{
+		const TCHAR* Name = nullptr;
+		int64 Value = 0;
+	};
+
+	struct FHitchFrame
+	{
+		uint64 FrameNumber = 0;
+		double StartTime = 0.0;
+		double FrameMs = 0.0;
+		// Negative until the next frame reports them
+		double GameThreadMs = 0.0;
+		double RenderThreadMs = 0.0;
+		TArray<FHitchEntry, TInlineAllocator<16>> Entries;
+		TArray<FHitchCounter, TInlineAllocator<8>> Counters;
+	};
+
+	FHitchFrame& GetCurrentFrame();
+
+	// Ring buffer, CurrentFrame is the one being recorded
+	TArray<FHitchFrame> Frames;
+	int32 CurrentFrame;
+	int32 NumRecordedFrames;
+
+	double LastDumpTime;
+
+	bool bDumpRequested;
+
+	FDelegateHandle EndFrameHandle;
+};
+
+// Times the enclosing scope for the hitch detector
+class FShooterHitchScope
+{
+public:
+	explicit FShooterHitchScope(const TCHAR* InName)
+		: Name(InName)
+		, StartTime(FPlatformTime::Seconds())
+	{
+	}
+
+	~FShooterHitchScope()
+	{
+		FShooterHitchDetector::Get().RecordTiming(Name, StartTime, FPlatformTime::Seconds());
+	}
+
+private:
+	const TCHAR* Name;
+	double StartTime;
+};
+
+#define SHOOTER_HITCH_SCOPE(Name) FShooterHitchScope PREPROCESSOR_JOIN(HitchScope_, __LINE__)(TEXT(Name))
+#define SHOOTER_HITCH_EVENT(Name) FShooterHitchDetector::Get().RecordEvent(TEXT(Name))
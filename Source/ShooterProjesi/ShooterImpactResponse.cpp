@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterImpactResponse.h"
+#include "ShooterDecalPoolSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Engine/World.h"
+
+void UShooterImpactResponseTable::PostLoad()
+{
+	Super::PostLoad();
+
+	BuildLookup();
+}
+
+#if WITH_EDITOR
+void UShooterImpactResponseTable::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BuildLookup();
+}
+#endif
+
+void UShooterImpactResponseTable::BuildLookup() const
+{
+	ResolvedResponses.Init(DefaultResponse, SurfaceType_Max);
+	for (const TPair<TEnumAsByte<EPhysicalSurface>, FShooterImpactResponse>& SurfaceResponse : SurfaceResponses)
+	{
+		ResolvedResponses[SurfaceResponse.Key.GetValue()] = SurfaceResponse.Value;
+	}
+}
+
+const FShooterImpactResponse& UShooterImpactResponseTable::GetResponse(EPhysicalSurface SurfaceType) const
+{
+	// Tables made at runtime have no PostLoad
+	if (ResolvedResponses.Num() == 0)
+	{
+		BuildLookup();
+	}
+	return ResolvedResponses[SurfaceType];
+}
+
+const FShooterImpactResponse& UShooterImpactResponseTable::GetResponse(const FHitResult& Hit) const
+{
+	return GetResponse(UPhysicalMaterial::DetermineSurfaceType(Hit.PhysMaterial.Get()));
+}
+
+void UShooterImpactResponseTable::PlayImpact(UWorld* World, const FHitResult& Hit) const
+{
+	const FShooterImpactResponse& Response = GetResponse(Hit);
+	const FRotator NormalRotation = Hit.ImpactNormal.Rotation();
+	if (Response.ImpactFX)
+	{
+		UGameplayStatics::SpawnEmitterAtLocation(World, Response.ImpactFX, Hit.Location, NormalRotation);
+	}
+	if (Response.ImpactSound)
+	{
+		UGameplayStatics::PlaySoundAtLocation(World, Response.ImpactSound, Hit.Location);
+	}
+	if (Response.DecalMaterial)
+	{
+		if (UShooterDecalPoolSubsystem* DecalPool = World->GetSubsystem<UShooterDecalPoolSubsystem>())
+		{
+			DecalPool->SpawnDecal(Response.DecalMaterial, Response.DecalSize, Hit.ImpactPoint, NormalRotation, Response.DecalLifeSpan);
+		}
+	}
+}
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Chaos/ChaosEngineInterface.h"
+#include "ShooterImpactResponse.generated.h"
+
+class UParticleSystem;
+class UMaterialInterface;
+class USoundBase;
+
+// What a bullet does to one kind of surface
+USTRUCT(BlueprintType)
+struct FShooterImpactResponse
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Impact")
+	UParticleSystem* ImpactFX = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Impact")
+	USoundBase* ImpactSound = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Impact")
+	UMaterialInterface* DecalMaterial = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Impact")
+	FVector DecalSize = FVector(4.f, 8.f, 8.f);
+
+	// Seconds before the decal starts fading out, see Shooter.Decals.FadeSeconds
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Impact", meta = (ClampMin = "0"))
+	float DecalLifeSpan = 10.f;
+
+	// Scales weapon damage on top of bone multipliers, e.g. for armored surfaces
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Impact", meta = (ClampMin = "0"))
+	float DamageMultiplier = 1.f;
+};
+
+/*
+	Impact responses by physical surface type. Lookups are an index into a flat array with one entry per surface,
+	built when the asset loads, surfaces without an entry use DefaultResponse. Assets are hard references and
+	load with the table, firing never loads anything. Weapon traces must set bReturnPhysicalMaterial.
+*/
+UCLASS(BlueprintType)
+class SHOOTERPROJESI_API UShooterImpactResponseTable : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	const FShooterImpactResponse& GetResponse(EPhysicalSurface SurfaceType) const;
+
+	// Surface of the hit's physical material
+	const FShooterImpactResponse& GetResponse(const FHitResult& Hit) const;
+
+	// Effects, sound and pooled decal of Hit's surface
+	void PlayImpact(UWorld* World, const FHitResult& Hit) const;
+
+private:
+	void BuildLookup() const;
+
+	UPROPERTY(EditAnywhere, Category = "Impact", meta = (AllowPrivateAccess = "true"))
+	FShooterImpactResponse DefaultResponse;
+
+	UPROPERTY(EditAnywhere, Category = "Impact", meta = (AllowPrivateAccess = "true"))
+	TMap<TEnumAsByte<EPhysicalSurface>, FShooterImpactResponse> SurfaceResponses;
+
+	// One entry per surface type, filled from DefaultResponse and SurfaceResponses
+	mutable TArray<FShooterImpactResponse> ResolvedResponses;
+};
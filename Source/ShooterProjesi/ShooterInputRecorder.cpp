@@ -0,0 +1,457 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterInputRecorder.h"
+#include "ShooterProjesi.h"
+#include "ShooterCharacter.h"
+#include "ShooterFixedStep.h"
+#include "Components/InputComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DELEGATE_TwoParams(FRecordedActionDelegate, uint8, bool);
+
+namespace ShooterInputRecorder
+{
+	// Axis and action mappings bound by AShooterCharacter and ADrone, order is part of the file format. New actions go at the end
+	static const FName Axes[] = { "MoveForward", "MoveRight", "MoveUp", "TurnRate", "LookUpRate", "Turn", "LookUp" };
+	static const FName Actions[] = { "Jump", "FireButton", "AimingButton", "Dash", "SwitchBetweenWeaponModes", "SwitchCameraSides", "SlowMotion", "DroneAbility", "SwapWeapon", "Select" };
+
+	static constexpr int32 NumAxes = UE_ARRAY_COUNT(Axes);
+	static constexpr int32 NumActions = UE_ARRAY_COUNT(Actions);
+	static_assert(NumAxes <= 8, "Changed axis mask is a single byte");
+
+	static constexpr uint32 FileMagic = 0x52495353; // "SSIR"
+	static constexpr uint16 FileVersion = 1;
+}
+
+bool FShooterInputRecording::SaveToFile(const FString& FileName) const
+{
+	using namespace ShooterInputRecorder;
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+
+	uint32 Magic = FileMagic;
+	uint16 Version = FileVersion;
+	uint8 AxisCount = NumAxes;
+	uint8 ActionCount = NumActions;
+	float FixedStep = FixedDeltaTime;
+	int32 FrameCount = Frames.Num();
+	Writer << Magic << Version << AxisCount << ActionCount << FixedStep << FrameCount;
+
+	// Frames only store axes that changed since the previous frame
+	TArray<float, TInlineAllocator<8>> PreviousValues;
+	PreviousValues.SetNumZeroed(NumAxes);
+	for (const FShooterInputFrame& Frame : Frames)
+	{
+		float DeltaTime = Frame.DeltaTime;
+		Writer << DeltaTime;
+
+		uint8 ChangedMask = 0;
+		for (int32 Axis = 0; Axis < NumAxes; ++Axis)
+		{
+			if (Frame.AxisValues[Axis] != PreviousValues[Axis])
+			{
+				ChangedMask |= 1 << Axis;
+			}
+		}
+		Writer << ChangedMask;
+		for (int32 Axis = 0; Axis < NumAxes; ++Axis)
+		{
+			if (ChangedMask & (1 << Axis))
+			{
+				float Value = Frame.AxisValues[Axis];
+				Writer << Value;
+				PreviousValues[Axis] = Value;
+			}
+		}
+
+		uint8 EventCount = static_cast<uint8>(FMath::Min(Frame.ActionEvents.Num(), 255));
+		Writer << EventCount;
+		for (int32 Event = 0; Event < EventCount; ++Event)
+		{
+			uint8 ActionEvent = Frame.ActionEvents[Event];
+			Writer << ActionEvent;
+		}
+	}
+
+	return FFileHelper::SaveArrayToFile(Bytes, *FileName);
+}
+
+bool FShooterInputRecording::LoadFromFile(const FString& FileName)
+{
+	using namespace ShooterInputRecorder;
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FileName))
+	{
+		return false;
+	}
+	FMemoryReader Reader(Bytes);
+
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	uint8 AxisCount = 0;
+	uint8 ActionCount = 0;
+	int32 FrameCount = 0;
+	Reader << Magic << Version << AxisCount << ActionCount << FixedDeltaTime << FrameCount;
+	// Actions are only ever appended, a recording made with fewer never presses the newer ones
+	if (Magic != FileMagic || Version != FileVersion || AxisCount != NumAxes || ActionCount > NumActions || FrameCount < 0)
+	{
+		return false;
+	}
+
+	TArray<float, TInlineAllocator<8>> Values;
+	Values.SetNumZeroed(NumAxes);
+	Frames.Reset(FrameCount);
+	for (int32 FrameIndex = 0; FrameIndex < FrameCount && !Reader.IsError(); ++FrameIndex)
+	{
+		FShooterInputFrame& Frame = Frames.AddDefaulted_GetRef();
+		Reader << Frame.DeltaTime;
+
+		uint8 ChangedMask = 0;
+		Reader << ChangedMask;
+		for (int32 Axis = 0; Axis < NumAxes; ++Axis)
+		{
+			if (ChangedMask & (1 << Axis))
+			{
+				Reader << Values[Axis];
+			}
+		}
+		Frame.AxisValues = Values;
+
+		uint8 EventCount = 0;
+		Reader << EventCount;
+		Frame.ActionEvents.SetNumUninitialized(EventCount);
+		for (int32 Event = 0; Event < EventCount; ++Event)
+		{
+			Reader << Frame.ActionEvents[Event];
+		}
+	}
+	return !Reader.IsError();
+}
+
+UShooterInputRecorderSubsystem::UShooterInputRecorderSubsystem()
+{
+	RecordInputComponent = nullptr;
+	ReplayBlockInputComponent = nullptr;
+	bReplaying = false;
+	ReplayFrameIndex = 0;
+	bQuitAfterReplay = false;
+	bPreviousUseFixedTimeStep = false;
+	PreviousFixedDeltaTime = 1.0 / 60.0;
+}
+
+void UShooterInputRecorderSubsystem::Deinitialize()
+{
+	StopRecording();
+	StopReplay();
+
+	Super::Deinitialize();
+}
+
+TStatId UShooterInputRecorderSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterInputRecorderSubsystem, STATGROUP_Tickables);
+}
+
+FString UShooterInputRecorderSubsystem::GetRecordingPath(const FString& RecordingName)
+{
+	return FPaths::ProjectSavedDir() / TEXT("InputRecordings") / RecordingName + TEXT(".sir");
+}
+
+void UShooterInputRecorderSubsystem::StartRecording(APlayerController* PlayerController, const FString& RecordingName)
+{
+	using namespace ShooterInputRecorder;
+
+	if (PlayerController == nullptr || IsRecording() || IsReplaying())
+	{
+		return;
+	}
+
+	// Listen on top of the input stack without consuming anything so the pawn still gets every input
+	RecordInputComponent = NewObject<UInputComponent>(PlayerController, TEXT("InputRecorder"));
+	for (const FName& Axis : Axes)
+	{
+		RecordInputComponent->BindAxis(Axis).bConsumeInput = false;
+	}
+	for (int32 Action = 0; Action < NumActions; ++Action)
+	{
+		RecordInputComponent->BindAction<FRecordedActionDelegate>(Actions[Action], IE_Pressed, this, &UShooterInputRecorderSubsystem::OnRecordedAction, static_cast<uint8>(Action), false).bConsumeInput = false;
+		RecordInputComponent->BindAction<FRecordedActionDelegate>(Actions[Action], IE_Released, this, &UShooterInputRecorderSubsystem::OnRecordedAction, static_cast<uint8>(Action), true).bConsumeInput = false;
+	}
+	PlayerController->PushInputComponent(RecordInputComponent);
+
+	RecordController = PlayerController;
+	RecordName = RecordingName;
+	Recording = FShooterInputRecording();
+	Recording.FixedDeltaTime = FApp::UseFixedTimeStep() ? FApp::GetFixedDeltaTime() : 1.f / 60.f;
+	PendingActionEvents.Reset();
+
+	UE_LOG(LogShooter, Display, TEXT("Input recording %s started"), *RecordName);
+}
+
+void UShooterInputRecorderSubsystem::StopRecording()
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+	if (APlayerController* PlayerController = RecordController.Get())
+	{
+		PlayerController->PopInputComponent(RecordInputComponent);
+	}
+	RecordInputComponent = nullptr;
+	RecordController.Reset();
+
+	const FString Path = GetRecordingPath(RecordName);
+	const bool bSaved = Recording.SaveToFile(Path);
+	UE_LOG(LogShooter, Display, TEXT("Input recording %s stopped, %d frames %s %s"), *RecordName, Recording.Frames.Num(), bSaved ? TEXT("saved to") : TEXT("FAILED to save to"), *Path);
+	Recording.Frames.Empty();
+}
+
+void UShooterInputRecorderSubsystem::OnRecordedAction(uint8 ActionIndex, bool bReleased)
+{
+	PendingActionEvents.Add(static_cast<uint8>((ActionIndex << 1) | (bReleased ? 1 : 0)));
+}
+
+// Runs after the player controller processed this frame's input
+void UShooterInputRecorderSubsystem::RecordFrame(float DeltaTime)
+{
+	using namespace ShooterInputRecorder;
+
+	FShooterInputFrame& Frame = Recording.Frames.AddDefaulted_GetRef();
+	Frame.DeltaTime = DeltaTime;
+	Frame.AxisValues.SetNumUninitialized(NumAxes);
+	for (int32 Axis = 0; Axis < NumAxes; ++Axis)
+	{
+		Frame.AxisValues[Axis] = RecordInputComponent->GetAxisValue(Axes[Axis]);
+	}
+	Frame.ActionEvents = PendingActionEvents;
+	PendingActionEvents.Reset();
+}
+
+bool UShooterInputRecorderSubsystem::StartReplay(APlayerController* PlayerController, const FString& RecordingName, bool bQuitWhenDone)
+{
+	if (PlayerController == nullptr || IsRecording() || IsReplaying())
+	{
+		return false;
+	}
+
+	const FString Path = GetRecordingPath(RecordingName);
+	if (!Recording.LoadFromFile(Path))
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Input replay: could not load %s"), *Path);
+		return false;
+	}
+
+	// Same timestep every run regardless of how fast the machine renders
+	bPreviousUseFixedTimeStep = FApp::UseFixedTimeStep();
+	PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(Recording.FixedDeltaTime);
+
+	bReplaying = true;
+	ReplayController = PlayerController;
+	ReplayFrameIndex = 0;
+	bQuitAfterReplay = bQuitWhenDone;
+
+	// Live devices would still call the pawn's bindings, and zero the stored axes, every controller tick
+	ReplayBlockInputComponent = NewObject<UInputComponent>(PlayerController, TEXT("InputReplayBlock"));
+	ReplayBlockInputComponent->bBlockInput = true;
+	ReplayBlockInputComponent->Priority = MAX_int32; // Stays above input components pushed during replay, e.g. the drone's
+	PlayerController->PushInputComponent(ReplayBlockInputComponent);
+
+	// Same point in the frame as live input relative to the steps that read it, whatever order the tickables run in
+	if (UShooterFixedStepSubsystem* FixedStep = GetWorld()->GetSubsystem<UShooterFixedStepSubsystem>())
+	{
+		PreStepsHandle = FixedStep->OnPreSteps.AddUObject(this, &UShooterInputRecorderSubsystem::AdvanceReplay);
+	}
+
+	UE_LOG(LogShooter, Display, TEXT("Input replay %s started, %d frames at %.4f s"), *RecordingName, Recording.Frames.Num(), Recording.FixedDeltaTime);
+	return true;
+}
+
+void UShooterInputRecorderSubsystem::StopReplay()
+{
+	if (!IsReplaying())
+	{
+		return;
+	}
+	bReplaying = false;
+	if (APlayerController* PlayerController = ReplayController.Get())
+	{
+		PlayerController->PopInputComponent(ReplayBlockInputComponent);
+	}
+	ReplayBlockInputComponent = nullptr;
+	ReplayController.Reset();
+	if (UShooterFixedStepSubsystem* FixedStep = GetWorld()->GetSubsystem<UShooterFixedStepSubsystem>())
+	{
+		FixedStep->OnPreSteps.Remove(PreStepsHandle);
+	}
+	PreStepsHandle.Reset();
+	FApp::SetUseFixedTimeStep(bPreviousUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+
+	UE_LOG(LogShooter, Display, TEXT("Input replay stopped after %d frames"), ReplayFrameIndex);
+	Recording.Frames.Empty();
+
+	if (bQuitAfterReplay)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+UInputComponent* UShooterInputRecorderSubsystem::GetReplayInputComponent() const
+{
+	APlayerController* PlayerController = ReplayController.Get();
+	APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	// The drone can be flown without possession, its bindings are on its own input component
+	if (AShooterCharacter* Character = Cast<AShooterCharacter>(Pawn))
+	{
+		Pawn = Character->GetActiveInputPawn();
+	}
+	return Pawn ? Pawn->InputComponent : nullptr;
+}
+
+void UShooterInputRecorderSubsystem::ReplayFrame()
+{
+	using namespace ShooterInputRecorder;
+
+	const FShooterInputFrame& Frame = Recording.Frames[ReplayFrameIndex];
+
+	// Actions first, they may change the possessed pawn. Delegates are copied because possession rebuilds input components
+	for (const uint8 ActionEvent : Frame.ActionEvents)
+	{
+		const int32 Action = ActionEvent >> 1;
+		const EInputEvent KeyEvent = (ActionEvent & 1) ? IE_Released : IE_Pressed;
+		UInputComponent* InputComponent = GetReplayInputComponent();
+		if (InputComponent == nullptr || Action >= NumActions)
+		{
+			continue;
+		}
+
+		TArray<FInputActionUnifiedDelegate, TInlineAllocator<2>> Delegates;
+		for (int32 BindingIndex = 0; BindingIndex < InputComponent->GetNumActionBindings(); ++BindingIndex)
+		{
+			const FInputActionBinding& Binding = InputComponent->GetActionBinding(BindingIndex);
+			if (Binding.GetActionName() == Actions[Action] && Binding.KeyEvent == KeyEvent)
+			{
+				Delegates.Add(Binding.ActionDelegate);
+			}
+		}
+		for (FInputActionUnifiedDelegate& Delegate : Delegates)
+		{
+			Delegate.Execute(EKeys::Invalid);
+		}
+	}
+
+	// Axes are fed every frame like live input does, zeros included
+	if (UInputComponent* InputComponent = GetReplayInputComponent())
+	{
+		for (FInputAxisBinding& Binding : InputComponent->AxisBindings)
+		{
+			for (int32 Axis = 0; Axis < NumAxes; ++Axis)
+			{
+				if (Binding.AxisName == Axes[Axis])
+				{
+					Binding.AxisValue = Frame.AxisValues[Axis];
+					Binding.AxisDelegate.Execute(Binding.AxisValue);
+					break;
+				}
+			}
+		}
+	}
+}
+
+void UShooterInputRecorderSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (IsRecording())
+	{
+		if (RecordController.IsValid())
+		{
+			RecordFrame(DeltaTime);
+		}
+		else
+		{
+			StopRecording();
+		}
+	}
+
+	if (IsReplaying() && !PreStepsHandle.IsValid())
+	{
+		AdvanceReplay();
+	}
+}
+
+void UShooterInputRecorderSubsystem::AdvanceReplay()
+{
+	if (!IsReplaying())
+	{
+		return;
+	}
+	if (!ReplayController.IsValid())
+	{
+		// Map change or controller teardown, still restores the timestep and quits if asked to
+		UE_LOG(LogShooter, Warning, TEXT("Input replay: player controller went away at frame %d"), ReplayFrameIndex);
+		StopReplay();
+	}
+	else if (ReplayFrameIndex < Recording.Frames.Num())
+	{
+		ReplayFrame();
+		++ReplayFrameIndex;
+	}
+	else
+	{
+		StopReplay();
+	}
+}
+
+static APlayerController* GetRecorderPlayerController(UWorld* World)
+{
+	return World ? UGameplayStatics::GetPlayerController(World, 0) : nullptr;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs InputRecordCommand(
+	TEXT("Shooter.Input.Record"),
+	TEXT("Starts recording player input. Usage: Shooter.Input.Record [Name=Session]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (UShooterInputRecorderSubsystem* Recorder = World ? World->GetSubsystem<UShooterInputRecorderSubsystem>() : nullptr)
+		{
+			Recorder->StartRecording(GetRecorderPlayerController(World), Args.Num() > 0 ? Args[0] : TEXT("Session"));
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld InputStopRecordCommand(
+	TEXT("Shooter.Input.StopRecord"),
+	TEXT("Stops recording player input and saves it to Saved/InputRecordings"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UShooterInputRecorderSubsystem* Recorder = World ? World->GetSubsystem<UShooterInputRecorderSubsystem>() : nullptr)
+		{
+			Recorder->StopRecording();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs InputReplayCommand(
+	TEXT("Shooter.Input.Replay"),
+	TEXT("Replays recorded input at a fixed timestep. Usage: Shooter.Input.Replay <Name> [QuitWhenDone=0]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UShooterInputRecorderSubsystem* Recorder = World ? World->GetSubsystem<UShooterInputRecorderSubsystem>() : nullptr;
+		if (Recorder && Args.Num() > 0)
+		{
+			Recorder->StartReplay(GetRecorderPlayerController(World), Args[0], Args.Num() > 1 && FCString::Atoi(*Args[1]) != 0);
+		}
+	}));
@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterInputRecorder.generated.h"
+
+class APlayerController;
+class UInputComponent;
+
+// One frame of recorded input
+struct FShooterInputFrame
+{
+	float DeltaTime = 0.f;
+
+	// Value of every recorded axis this frame
+	TArray<float, TInlineAllocator<8>> AxisValues;
+
+	// Action events this frame, (ActionIndex << 1) | bReleased
+	TArray<uint8, TInlineAllocator<4>> ActionEvents;
+};
+
+// A recorded session, serialized as a small binary file where only changed axes are stored per frame
+struct FShooterInputRecording
+{
+	// Delta time replay runs at
+	float FixedDeltaTime = 1.f / 60.f;
+
+	TArray<FShooterInputFrame> Frames;
+
+	bool SaveToFile(const FString& FileName) const;
+
+	bool LoadFromFile(const FString& FileName);
+};
+
+/*
+	Records the axis and action inputs that drive AShooterCharacter and ADrone and replays them headless at a fixed timestep.
+	Recording listens through a non-consuming input component on top of the player controller's input stack,
+	replay calls the bindings of the pawn's input component directly, so both work for whichever pawn is possessed.
+	Replayed frames are applied from the fixed step's OnPreSteps, after the controller's input and before any step reads
+	the stored axis values, and a blocking input component keeps live devices out while replaying.
+*/
+UCLASS()
+class SHOOTERPROJESI_API UShooterInputRecorderSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UShooterInputRecorderSubsystem();
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	void StartRecording(APlayerController* PlayerController, const FString& RecordingName);
+
+	void StopRecording();
+
+	// Replays a recording on PlayerController's pawn with a fixed engine timestep, optionally quits when done
+	bool StartReplay(APlayerController* PlayerController, const FString& RecordingName, bool bQuitWhenDone);
+
+	void StopReplay();
+
+	FORCEINLINE bool IsRecording() const { return RecordInputComponent != nullptr; }
+
+	FORCEINLINE bool IsReplaying() const { return bReplaying; }
+
+	static FString GetRecordingPath(const FString& RecordingName);
+
+private:
+	void OnRecordedAction(uint8 ActionIndex, bool bReleased);
+
+	void RecordFrame(float DeltaTime);
+
+	// Applies the next frame, or stops the replay when it is done or the controller went away
+	void AdvanceReplay();
+
+	void ReplayFrame();
+
+	// Input component the replayed bindings are called on
+	UInputComponent* GetReplayInputComponent() const;
+
+	UPROPERTY()
+	UInputComponent* RecordInputComponent;
+
+	TWeakObjectPtr<APlayerController> RecordController;
+
+	FString RecordName;
+
+	FShooterInputRecording Recording;
+
+	// Action events received since the last recorded frame
+	TArray<uint8, TInlineAllocator<4>> PendingActionEvents;
+
+	// Kept apart from ReplayController, the controller can be destroyed mid replay and the engine state still has to be restored
+	bool bReplaying;
+
+	TWeakObjectPtr<APlayerController> ReplayController;
+
+	// Blocks live input to the pawn while replaying, on top of the controller's input stack
+	UPROPERTY()
+	UInputComponent* ReplayBlockInputComponent;
+
+	// Binding to the fixed step's OnPreSteps, replay falls back to this subsystem's tick without one
+	FDelegateHandle PreStepsHandle;
+
+	int32 ReplayFrameIndex;
+
+	bool bQuitAfterReplay;
+
+	// Engine fixed timestep settings before replay started
+	bool bPreviousUseFixedTimeStep;
+	double PreviousFixedDeltaTime;
+};
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterItemRenderSubsystem.h"
+#include "Item.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+
+void UShooterItemRenderSubsystem::Deinitialize()
+{
+	// Instance owner is transient and goes away with the world
+	Batches.Reset();
+	InstanceOwner = nullptr;
+
+	Super::Deinitialize();
+}
+
+FShooterItemInstanceBatch& UShooterItemRenderSubsystem::FindOrAddBatch(UStaticMesh* Mesh)
+{
+	if (FShooterItemInstanceBatch* Batch = Batches.Find(Mesh))
+	{
+		return *Batch;
+	}
+
+	if (InstanceOwner == nullptr)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Name = TEXT("ShooterItemInstances");
+		SpawnParams.ObjectFlags |= RF_Transient;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		InstanceOwner = GetWorld()->SpawnActor<AActor>(SpawnParams);
+
+		USceneComponent* Root = NewObject<USceneComponent>(InstanceOwner, TEXT("Root"));
+		InstanceOwner->SetRootComponent(Root);
+		Root->RegisterComponent();
+	}
+
+	// Instances are drawn only, items keep their own collision box for focus queries and pickup
+	UInstancedStaticMeshComponent* Instances = NewObject<UInstancedStaticMeshComponent>(InstanceOwner);
+	Instances->SetStaticMesh(Mesh);
+	Instances->SetMobility(EComponentMobility::Movable);
+	Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Instances->SetupAttachment(InstanceOwner->GetRootComponent());
+	Instances->RegisterComponent();
+
+	FShooterItemInstanceBatch& Batch = Batches.Add(Mesh);
+	Batch.Instances = Instances;
+	return Batch;
+}
+
+void UShooterItemRenderSubsystem::AddItem(AItem* Item, UStaticMesh* Mesh, const FTransform& Transform)
+{
+	if (Item == nullptr || Mesh == nullptr)
+	{
+		return;
+	}
+
+	FShooterItemInstanceBatch& Batch = FindOrAddBatch(Mesh);
+	Batch.Instances->AddInstance(Transform, true);
+	Batch.InstanceItems.Add(Item);
+}
+
+void UShooterItemRenderSubsystem::RemoveItem(AItem* Item, UStaticMesh* Mesh)
+{
+	FShooterItemInstanceBatch* Batch = Batches.Find(Mesh);
+	const int32 InstanceIndex = Batch ? Batch->InstanceItems.Find(Item) : INDEX_NONE;
+	if (InstanceIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Removing from the middle would shift every later instance, move the last one into the gap instead
+	const int32 LastIndex = Batch->InstanceItems.Num() - 1;
+	if (InstanceIndex != LastIndex)
+	{
+		FTransform LastTransform;
+		Batch->Instances->GetInstanceTransform(LastIndex, LastTransform, true);
+		Batch->Instances->UpdateInstanceTransform(InstanceIndex, LastTransform, true, false, true);
+	}
+	Batch->Instances->RemoveInstance(LastIndex);
+	Batch->InstanceItems.RemoveAtSwap(InstanceIndex);
+}
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterItemRenderSubsystem.generated.h"
+
+class AItem;
+class UStaticMesh;
+class UInstancedStaticMeshComponent;
+
+// All dropped items sharing a static mesh
+USTRUCT()
+struct FShooterItemInstanceBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UInstancedStaticMeshComponent* Instances = nullptr;
+
+	// Item drawn by each instance, same order as the instances
+	UPROPERTY()
+	TArray<AItem*> InstanceItems;
+};
+
+/*
+	Draws dropped items as instances of one instanced static mesh component per item mesh, so loot on the ground
+	costs no skeletal mesh component, skinning or bone transforms. Items switch back to their skeletal mesh when equipped.
+*/
+UCLASS()
+class SHOOTERPROJESI_API UShooterItemRenderSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Starts drawing Item as an instance of Mesh at Transform
+	void AddItem(AItem* Item, UStaticMesh* Mesh, const FTransform& Transform);
+
+	// Stops drawing Item, the last instance of its batch takes its place
+	void RemoveItem(AItem* Item, UStaticMesh* Mesh);
+
+	FORCEINLINE int32 GetNumBatches() const { return Batches.Num(); }
+
+private:
+	FShooterItemInstanceBatch& FindOrAddBatch(UStaticMesh* Mesh);
+
+	// Owns the instanced components, spawned with the first batch
+	UPROPERTY()
+	AActor* InstanceOwner;
+
+	UPROPERTY()
+	TMap<UStaticMesh*, FShooterItemInstanceBatch> Batches;
+};
@@ -0,0 +1,201 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterLineOfSightSubsystem.h"
+#include "ShooterProjesi.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarLineOfSightTracesPerFrame(
+	TEXT("Shooter.LOS.TracesPerFrame"),
+	64,
+	TEXT("Most line of sight traces issued per frame, the rest wait for the next frames"));
+
+static TAutoConsoleVariable<float> CVarLineOfSightEvictAge(
+	TEXT("Shooter.LOS.EvictAge"),
+	5.f,
+	TEXT("Seconds a line of sight pair is kept after it was last asked for"));
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("LOS Traces Issued"), STAT_ShooterLOSTraces, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LOS Pending Pairs"), STAT_ShooterLOSPending, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LOS Cached Pairs"), STAT_ShooterLOSPairs, STATGROUP_Shooter);
+
+namespace ShooterLineOfSight
+{
+	static FVector GetEyeLocation(const AActor* Actor)
+	{
+		const APawn* Pawn = Cast<APawn>(Actor);
+		return Pawn ? Pawn->GetPawnViewLocation() : Actor->GetActorLocation();
+	}
+}
+
+UShooterLineOfSightSubsystem::UShooterLineOfSightSubsystem()
+{
+	NextTraceId = 0;
+	LastEvictionTime = 0.0;
+	NumRequests = 0;
+	NumCacheHits = 0;
+	NumDedupedRequests = 0;
+	NumTraces = 0;
+
+	TraceDelegate.BindUObject(this, &UShooterLineOfSightSubsystem::OnTraceCompleted);
+}
+
+void UShooterLineOfSightSubsystem::Deinitialize()
+{
+	// Completions of traces still in flight find nothing to update
+	InFlightTraces.Reset();
+	PendingPairs.Reset();
+	Pairs.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId UShooterLineOfSightSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterLineOfSightSubsystem, STATGROUP_Tickables);
+}
+
+FShooterLineOfSightResult UShooterLineOfSightSubsystem::GetLineOfSight(const AActor* Viewer, const AActor* Target, float MaxAge)
+{
+	FShooterLineOfSightResult Result;
+	if (Viewer == nullptr || Target == nullptr)
+	{
+		return Result;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	FPairEntry& Entry = Pairs.FindOrAdd(FPairKey{ Viewer, Target });
+	Entry.LastRequestTime = Now;
+	++NumRequests;
+
+	Result.bHasResult = Entry.bHasResult;
+	Result.bVisible = Entry.bVisible;
+	Result.Age = Entry.bHasResult ? static_cast<float>(Now - Entry.ResultTime) : 0.f;
+
+	if (Entry.bHasResult && Result.Age <= MaxAge)
+	{
+		++NumCacheHits;
+	}
+	else if (Entry.bQueued)
+	{
+		++NumDedupedRequests; // Another caller already asked for this pair
+	}
+	else
+	{
+		Entry.bQueued = true;
+		PendingPairs.Add(FPairKey{ Viewer, Target });
+	}
+	return Result;
+}
+
+void UShooterLineOfSightSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	IssueTraces();
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (Now - LastEvictionTime > 1.0)
+	{
+		LastEvictionTime = Now;
+		EvictUnusedPairs();
+	}
+
+	SET_DWORD_STAT(STAT_ShooterLOSPending, PendingPairs.Num());
+	SET_DWORD_STAT(STAT_ShooterLOSPairs, Pairs.Num());
+}
+
+void UShooterLineOfSightSubsystem::IssueTraces()
+{
+	UWorld* World = GetWorld();
+	const double Now = World->GetTimeSeconds();
+	const int32 Budget = FMath::Max(CVarLineOfSightTracesPerFrame.GetValueOnGameThread(), 1);
+
+	int32 NumIssued = 0;
+	int32 NumConsumed = 0;
+	while (NumConsumed < PendingPairs.Num() && NumIssued < Budget)
+	{
+		const FPairKey& Key = PendingPairs[NumConsumed++];
+		const AActor* Viewer = Key.Viewer.Get();
+		const AActor* Target = Key.Target.Get();
+		if (Viewer == nullptr || Target == nullptr)
+		{
+			Pairs.Remove(Key);
+			continue;
+		}
+
+		if (!Pairs.Contains(Key))
+		{
+			continue; // Evicted while waiting
+		}
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterLineOfSight), false, Viewer);
+		QueryParams.AddIgnoredActor(Target);
+
+		const uint32 TraceId = NextTraceId++;
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Test,
+			ShooterLineOfSight::GetEyeLocation(Viewer), Target->GetActorLocation(),
+			ECC_Visibility, QueryParams, FCollisionResponseParams::DefaultResponseParam,
+			&TraceDelegate, TraceId);
+
+		// Age is measured from the moment the world was sampled, the entry keeps its previous result until then
+		InFlightTraces.Add(TraceId, FInFlightTrace{ Key, Now });
+		++NumIssued;
+	}
+	PendingPairs.RemoveAt(0, NumConsumed, false);
+
+	NumTraces += NumIssued;
+	SET_DWORD_STAT(STAT_ShooterLOSTraces, NumIssued);
+}
+
+void UShooterLineOfSightSubsystem::OnTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	FInFlightTrace Trace;
+	if (!InFlightTraces.RemoveAndCopyValue(TraceDatum.UserData, Trace))
+	{
+		return;
+	}
+
+	if (FPairEntry* Entry = Pairs.Find(Trace.Key))
+	{
+		Entry->ResultTime = Trace.IssueTime;
+		Entry->bVisible = !TraceDatum.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+		Entry->bHasResult = true;
+		Entry->bQueued = false;
+	}
+}
+
+void UShooterLineOfSightSubsystem::EvictUnusedPairs()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double EvictAge = CVarLineOfSightEvictAge.GetValueOnGameThread();
+	for (auto It = Pairs.CreateIterator(); It; ++It)
+	{
+		const bool bUnused = Now - It.Value().LastRequestTime > EvictAge;
+		const bool bStale = !It.Key().Viewer.IsValid() || !It.Key().Target.IsValid();
+		// Queued pairs are cleaned up when their trace completes or is skipped
+		if ((bUnused || bStale) && !It.Value().bQueued)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UShooterLineOfSightSubsystem::LogStats() const
+{
+	UE_LOG(LogShooter, Display, TEXT("Line of sight: %llu requests, %llu cached, %llu deduped, %llu traces, %d pairs, %d pending, %d in flight"),
+		NumRequests, NumCacheHits, NumDedupedRequests, NumTraces, Pairs.Num(), PendingPairs.Num(), InFlightTraces.Num());
+}
+
+static FAutoConsoleCommandWithWorld LineOfSightStatsCommand(
+	TEXT("Shooter.LOS.Stats"),
+	TEXT("Logs line of sight request, cache and trace counts"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShooterLineOfSightSubsystem* LineOfSight = World ? World->GetSubsystem<UShooterLineOfSightSubsystem>() : nullptr)
+		{
+			LineOfSight->LogStats();
+		}
+	}));
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "ShooterLineOfSightSubsystem.generated.h"
+
+// Cached answer to a line of sight query
+struct FShooterLineOfSightResult
+{
+	// False until the first trace for the pair has completed
+	bool bHasResult = false;
+
+	bool bVisible = false;
+
+	// Seconds since the trace behind this result was issued
+	float Age = 0.f;
+};
+
+/*
+	Line of sight service for AI perception. Callers ask for a viewer/target pair and get the cached result straight away,
+	a stale pair is queued once no matter how many callers ask for it. Queued pairs are traced asynchronously, at most
+	Shooter.LOS.TracesPerFrame per frame, so perception cost is bounded by the budget and not by the number of bots.
+*/
+UCLASS()
+class SHOOTERPROJESI_API UShooterLineOfSightSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UShooterLineOfSightSubsystem();
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	// Cached line of sight from Viewer's eyes to Target, queues a new trace when the result is older than MaxAge
+	FShooterLineOfSightResult GetLineOfSight(const AActor* Viewer, const AActor* Target, float MaxAge);
+
+	void LogStats() const;
+
+private:
+	struct FPairKey
+	{
+		TWeakObjectPtr<const AActor> Viewer;
+		TWeakObjectPtr<const AActor> Target;
+
+		bool operator==(const FPairKey& Other) const { return Viewer == Other.Viewer && Target == Other.Target; }
+
+		friend uint32 GetTypeHash(const FPairKey& Key) { return HashCombine(GetTypeHash(Key.Viewer), GetTypeHash(Key.Target)); }
+	};
+
+	struct FPairEntry
+	{
+		// World time the trace of the current result was issued, set once that trace completes
+		double ResultTime = 0.0;
+
+		// World time of the last GetLineOfSight for this pair, unused pairs are evicted
+		double LastRequestTime = 0.0;
+
+		bool bHasResult = false;
+
+		bool bVisible = false;
+
+		// Waiting in PendingPairs or in flight
+		bool bQueued = false;
+	};
+
+	struct FInFlightTrace
+	{
+		FPairKey Key;
+
+		// World time the trace sampled the world, becomes the pair's ResultTime on completion
+		double IssueTime = 0.0;
+	};
+
+	void IssueTraces();
+
+	void OnTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	void EvictUnusedPairs();
+
+	TMap<FPairKey, FPairEntry> Pairs;
+
+	// Pairs waiting for a trace, oldest first
+	TArray<FPairKey> PendingPairs;
+
+	// Traces issued and not completed yet, by trace user data
+	TMap<uint32, FInFlightTrace> InFlightTraces;
+
+	uint32 NextTraceId;
+
+	FTraceDelegate TraceDelegate;
+
+	double LastEvictionTime;
+
+	// Totals for LogStats
+	uint64 NumRequests;
+	uint64 NumCacheHits;
+	uint64 NumDedupedRequests;
+	uint64 NumTraces;
+};
@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "ShooterPickupWidget.generated.h"
+
+class AItem;
+
+/*
+	Screen space pickup widget. A few of these are pooled by AShooterHUD and handed to the items in focus,
+	the blueprint fills in the item's details in SetItem.
+*/
+UCLASS(Abstract, Blueprintable)
+class SHOOTERPROJESI_API UShooterPickupWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	// Called when the widget is assigned to an item
+	UFUNCTION(BlueprintImplementableEvent, Category = "Pickup")
+	void SetItem(AItem* Item);
+};
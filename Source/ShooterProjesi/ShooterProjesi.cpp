@@ -1,6 +1,27 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#include "ShooterProjesi.h"
-#include "Modules/ModuleManager.h"
-
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, ShooterProjesi, "ShooterProjesi" );
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterProjesi.h"
+#include "ShooterHitchDetector.h"
+#include "Modules/ModuleManager.h"
+
+DEFINE_LOG_CATEGORY(LogShooter);
+
+class FShooterProjesiModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		// Cooks and other commandlets have no game frames to watch
+		if (!IsRunningCommandlet())
+		{
+			FShooterHitchDetector::Get().Start();
+		}
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FShooterHitchDetector::Get().Stop();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FShooterProjesiModule, ShooterProjesi, "ShooterProjesi" );
@@ -1,6 +1,19 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#pragma once
-
-#include "CoreMinimal.h"
-
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogShooter, Log, All);
+
+/*
+	Weapon hitscan channel. Needs these lines in Config/DefaultEngine.ini under [/Script/Engine.CollisionProfile]:
+	+DefaultChannelResponses=(Channel=ECC_GameTraceChannel1,DefaultResponse=ECR_Block,bTraceType=True,bStaticObject=False,Name="Weapon")
+	+EditProfiles=(Name="Pawn",CustomResponses=((Channel="Weapon",Response=ECR_Ignore)))
+	+EditProfiles=(Name="CharacterMesh",CustomResponses=((Channel="Weapon",Response=ECR_Block)))
+	Characters are hit on the simple bodies of their physics asset, never on the capsule or per triangle collision.
+*/
+#define COLLISION_WEAPON ECC_GameTraceChannel1
+
+DECLARE_STATS_GROUP(TEXT("Shooter"), STATGROUP_Shooter, STATCAT_Advanced);
+
@@ -1,5 +1,11 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-
-#include "ShooterProjesiGameModeBase.h"
-
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterProjesiGameModeBase.h"
+#include "ShooterHUD.h"
+
+AShooterProjesiGameModeBase::AShooterProjesiGameModeBase()
+{
+	HUDClass = AShooterHUD::StaticClass();
+}
+
@@ -1,17 +1,20 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/GameModeBase.h"
-#include "ShooterProjesiGameModeBase.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class SHOOTERPROJESI_API AShooterProjesiGameModeBase : public AGameModeBase
-{
-	GENERATED_BODY()
-	
-};
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "ShooterProjesiGameModeBase.generated.h"
+
+/**
+ * 
+ */
+UCLASS()
+class SHOOTERPROJESI_API AShooterProjesiGameModeBase : public AGameModeBase
+{
+	GENERATED_BODY()
+
+public:
+	AShooterProjesiGameModeBase();
+	
+};
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterShotBatch.h"
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+#include "Async/ParallelFor.h"
+
+void FShooterShotBatch::AddRay(const FVector& Direction)
+{
+	FShooterShotRayResult& Result = Results.AddDefaulted_GetRef();
+	Result.Direction = Direction.GetSafeNormal();
+}
+
+void FShooterShotBatch::Evaluate(const UWorld* World, const FShooterShotBatchParams& Params)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FShooterShotBatch::Evaluate);
+
+	// A single ray isn't worth a task
+	const EParallelForFlags Flags = Results.Num() > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+	ParallelFor(Results.Num(), [World, &Params, this](int32 RayIndex)
+	{
+		EvaluateRay(World, Params, Results[RayIndex]);
+	}, Flags);
+}
+
+void FShooterShotBatch::EvaluateRay(const UWorld* World, const FShooterShotBatchParams& Params, FShooterShotRayResult& Result)
+{
+	// Trace outward from crosshairs world location
+	const FVector End = Params.ViewLocation + Result.Direction * Params.Range;
+	Result.BeamEnd = End;
+
+	FHitResult ScreenTraceHit;
+	if (!World->LineTraceSingleByChannel(ScreenTraceHit, Params.ViewLocation, End, Params.Channel, Params.QueryParams))
+	{
+		return;
+	}
+
+	// Second trace from gun barrel, something between the barrel and the crosshair target is hit first
+	FHitResult Hit = ScreenTraceHit;
+	FHitResult WeaponTraceHit;
+	if (World->LineTraceSingleByChannel(WeaponTraceHit, Params.MuzzleLocation, ScreenTraceHit.Location, Params.Channel, Params.QueryParams))
+	{
+		Hit = WeaponTraceHit;
+	}
+
+	const FVector TravelDirection = (Hit.TraceEnd - Hit.TraceStart).GetSafeNormal();
+	float DamageScale = 1.f;
+	FCollisionQueryParams PenetrationParams = Params.QueryParams;
+
+	for (int32 Penetration = 0; ; ++Penetration)
+	{
+		Result.Hits.Add(Hit);
+		Result.DamageScales.Add(DamageScale);
+		Result.BeamEnd = Hit.Location;
+
+		if (Penetration >= Params.MaxPenetrations || Params.PenetrationDepth <= 0.f)
+		{
+			break;
+		}
+
+		// Look for the exit point by tracing back from PenetrationDepth behind the entry, no hit means the surface is too thick
+		const FVector BehindSurface = Hit.Location + TravelDirection * Params.PenetrationDepth;
+		FHitResult ExitHit;
+		if (!Hit.GetComponent() || !Hit.GetComponent()->LineTraceComponent(ExitHit, BehindSurface, Hit.Location, FCollisionQueryParams(SCENE_QUERY_STAT(ShooterPenetrationExit), false)))
+		{
+			break;
+		}
+
+		// Continue from the exit point, ignoring the actor we just went through
+		if (Hit.GetActor())
+		{
+			PenetrationParams.AddIgnoredActor(Hit.GetActor());
+		}
+		DamageScale *= Params.PenetrationDamageScale;
+		const FVector ExitLocation = ExitHit.Location + TravelDirection;
+		FHitResult NextHit;
+		if (!World->LineTraceSingleByChannel(NextHit, ExitLocation, ExitLocation + TravelDirection * Params.Range, Params.Channel, PenetrationParams))
+		{
+			Result.BeamEnd = ExitLocation + TravelDirection * Params.Range;
+			break;
+		}
+		Hit = NextHit;
+	}
+}
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "CollisionQueryParams.h"
+
+class UWorld;
+
+struct FShooterShotBatchParams
+{
+	// Crosshair world position every ray starts from
+	FVector ViewLocation = FVector::ZeroVector;
+
+	// Barrel location, each ray is re-traced from here to what the crosshair trace hit
+	FVector MuzzleLocation = FVector::ZeroVector;
+
+	float Range = 50'000.f;
+
+	ECollisionChannel Channel = ECC_Visibility;
+
+	FCollisionQueryParams QueryParams;
+
+	// Number of surfaces a ray may pass through after its first hit
+	int32 MaxPenetrations = 0;
+
+	// Thickest surface a ray can pass through
+	float PenetrationDepth = 0.f;
+
+	// Damage scale applied after each penetration
+	float PenetrationDamageScale = 1.f;
+};
+
+// Everything a single ray of the batch hit, in order along the ray
+struct FShooterShotRayResult
+{
+	FVector Direction = FVector::ZeroVector;
+
+	// Where the beam of this ray ends
+	FVector BeamEnd = FVector::ZeroVector;
+
+	TArray<FHitResult, TInlineAllocator<3>> Hits;
+
+	// Damage scale of each hit, 1 for the first and PenetrationDamageScale^N after N penetrations
+	TArray<float, TInlineAllocator<3>> DamageScales;
+};
+
+/*
+	All rays of one shot (shotgun pellets, penetrating round) traced together.
+	Rays are independent so they are evaluated in parallel on worker threads, scene queries are read only
+	the same way the engine's async traces run them.
+*/
+class SHOOTERPROJESI_API FShooterShotBatch
+{
+public:
+	void AddRay(const FVector& Direction);
+
+	// Traces every ray, blocks until all rays are done
+	void Evaluate(const UWorld* World, const FShooterShotBatchParams& Params);
+
+	FORCEINLINE const TArray<FShooterShotRayResult>& GetResults() const { return Results; }
+
+private:
+	static void EvaluateRay(const UWorld* World, const FShooterShotBatchParams& Params, FShooterShotRayResult& Result);
+
+	TArray<FShooterShotRayResult> Results;
+};
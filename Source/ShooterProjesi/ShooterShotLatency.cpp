@@ -0,0 +1,224 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterShotLatency.h"
+#include "ShooterProjesi.h"
+#include "RenderingThread.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+static TAutoConsoleVariable<int32> CVarShotLatencyEnabled(
+	TEXT("Shooter.Latency.Enabled"),
+	1,
+	TEXT("Track input to rendered frame latency of every shot"));
+
+FShooterShotLatencyTracker& FShooterShotLatencyTracker::Get()
+{
+	static FShooterShotLatencyTracker Tracker;
+	return Tracker;
+}
+
+FShooterShotLatencyTracker::FShooterShotLatencyTracker()
+	: PendingInputTime(0.0)
+	, NextShotId(1)
+{
+	Reset();
+	FCoreDelegates::OnEndFrameRT.AddRaw(this, &FShooterShotLatencyTracker::OnEndFrameRenderThread);
+}
+
+const TCHAR* FShooterShotLatencyTracker::GetStageName(EShotLatencyStage Stage)
+{
+	switch (Stage)
+	{
+	case EShotLatencyStage::Input: return TEXT("Input");
+	case EShotLatencyStage::Fire: return TEXT("Fire");
+	case EShotLatencyStage::MuzzleFX: return TEXT("MuzzleFX");
+	case EShotLatencyStage::TraceResolved: return TEXT("TraceResolved");
+	case EShotLatencyStage::Rendered: return TEXT("Rendered");
+	default: return TEXT("Unknown");
+	}
+}
+
+void FShooterShotLatencyTracker::MarkInput()
+{
+	PendingInputTime = FPlatformTime::Seconds();
+}
+
+uint32 FShooterShotLatencyTracker::BeginShot()
+{
+	if (CVarShotLatencyEnabled.GetValueOnGameThread() == 0)
+	{
+		PendingInputTime = 0.0;
+		return 0;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	const uint32 ShotId = NextShotId++;
+	if (NextShotId == 0)
+	{
+		NextShotId = 1; // 0 means untracked
+	}
+
+	FShotRecord Record;
+	for (double& StageTime : Record.StageTimes)
+	{
+		StageTime = 0.0;
+	}
+	// Auto fire shots after the first one have no input event, they are measured from the timer
+	Record.StageTimes[static_cast<int32>(EShotLatencyStage::Input)] = PendingInputTime > 0.0 ? PendingInputTime : Now;
+	Record.StageTimes[static_cast<int32>(EShotLatencyStage::Fire)] = Now;
+	PendingInputTime = 0.0;
+
+	{
+		FScopeLock ScopeLock(&Lock);
+		// Shots that never reach a rendered frame (no viewport, world torn down) must not pile up
+		if (InFlightShots.Num() > 256)
+		{
+			InFlightShots.Reset();
+		}
+		InFlightShots.Add(ShotId, Record);
+	}
+
+	TRACE_BOOKMARK(TEXT("Shot %u Input"), ShotId);
+	return ShotId;
+}
+
+void FShooterShotLatencyTracker::MarkStage(uint32 ShotId, EShotLatencyStage Stage)
+{
+	if (ShotId == 0)
+	{
+		return;
+	}
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (FShotRecord* Record = InFlightShots.Find(ShotId))
+		{
+			Record->StageTimes[static_cast<int32>(Stage)] = FPlatformTime::Seconds();
+		}
+	}
+	TRACE_BOOKMARK(TEXT("Shot %u %s"), ShotId, GetStageName(Stage));
+}
+
+void FShooterShotLatencyTracker::SubmitShot(uint32 ShotId)
+{
+	if (ShotId == 0)
+	{
+		return;
+	}
+
+	// Reaches the render thread together with the FX spawned this frame
+	ENQUEUE_RENDER_COMMAND(ShooterShotLatencySubmit)([ShotId](FRHICommandListImmediate& RHICmdList)
+	{
+		FShooterShotLatencyTracker& Tracker = FShooterShotLatencyTracker::Get();
+		FScopeLock ScopeLock(&Tracker.Lock);
+		Tracker.RenderThreadShots.Add(ShotId);
+	});
+}
+
+void FShooterShotLatencyTracker::OnEndFrameRenderThread()
+{
+	FScopeLock ScopeLock(&Lock);
+	if (RenderThreadShots.Num() == 0)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	for (const uint32 ShotId : RenderThreadShots)
+	{
+		FShotRecord Record;
+		if (InFlightShots.RemoveAndCopyValue(ShotId, Record))
+		{
+			Record.StageTimes[static_cast<int32>(EShotLatencyStage::Rendered)] = Now;
+			RecordCompletedShot(Record.StageTimes);
+			TRACE_BOOKMARK(TEXT("Shot %u Rendered"), ShotId);
+		}
+	}
+	RenderThreadShots.Reset();
+}
+
+// Lock must be held
+void FShooterShotLatencyTracker::RecordCompletedShot(const double* StageTimes)
+{
+	const double InputTime = StageTimes[static_cast<int32>(EShotLatencyStage::Input)];
+	for (int32 Stage = 0; Stage < NumStages; ++Stage)
+	{
+		if (StageTimes[Stage] <= 0.0)
+		{
+			continue; // Stage skipped, e.g. no muzzle socket
+		}
+		const double LatencyMs = (StageTimes[Stage] - InputTime) * 1000.0;
+		const int32 Bucket = FMath::Clamp(FMath::FloorToInt(LatencyMs), 0, NumBuckets - 1);
+		++Histograms[Stage][Bucket];
+		++StageCounts[Stage];
+		StageTotalsMs[Stage] += LatencyMs;
+		StageMaxMs[Stage] = FMath::Max(StageMaxMs[Stage], LatencyMs);
+	}
+	++NumCompletedShots;
+}
+
+void FShooterShotLatencyTracker::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+	FMemory::Memzero(Histograms);
+	FMemory::Memzero(StageCounts);
+	FMemory::Memzero(StageTotalsMs);
+	FMemory::Memzero(StageMaxMs);
+	NumCompletedShots = 0;
+}
+
+void FShooterShotLatencyTracker::Dump() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	UE_LOG(LogShooter, Display, TEXT("Shot latency over %d shots (ms after input)"), NumCompletedShots);
+	for (int32 Stage = 0; Stage < NumStages; ++Stage)
+	{
+		UE_LOG(LogShooter, Display, TEXT("  %-14s avg %7.2f  max %7.2f"),
+			GetStageName(static_cast<EShotLatencyStage>(Stage)),
+			StageCounts[Stage] > 0 ? StageTotalsMs[Stage] / StageCounts[Stage] : 0.0,
+			StageMaxMs[Stage]);
+	}
+
+	// One row per bucket, one column per stage
+	FString Csv = TEXT("LatencyMs");
+	for (int32 Stage = 0; Stage < NumStages; ++Stage)
+	{
+		Csv += FString::Printf(TEXT(",%s"), GetStageName(static_cast<EShotLatencyStage>(Stage)));
+	}
+	Csv += LINE_TERMINATOR;
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		Csv += Bucket == NumBuckets - 1 ? FString::Printf(TEXT("%d+"), Bucket) : FString::FromInt(Bucket);
+		for (int32 Stage = 0; Stage < NumStages; ++Stage)
+		{
+			Csv += FString::Printf(TEXT(",%d"), Histograms[Stage][Bucket]);
+		}
+		Csv += LINE_TERMINATOR;
+	}
+
+	const FString Path = FPaths::ProfilingDir() / TEXT("ShotLatency.csv");
+	if (FFileHelper::SaveStringToFile(Csv, *Path))
+	{
+		UE_LOG(LogShooter, Display, TEXT("Shot latency histogram written to %s"), *Path);
+	}
+}
+
+static FAutoConsoleCommand ShotLatencyDumpCommand(
+	TEXT("Shooter.Latency.Dump"),
+	TEXT("Logs per stage shot latency and writes the histogram to Saved/Profiling/ShotLatency.csv"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FShooterShotLatencyTracker::Get().Dump();
+	}));
+
+static FAutoConsoleCommand ShotLatencyResetCommand(
+	TEXT("Shooter.Latency.Reset"),
+	TEXT("Clears the shot latency histogram"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FShooterShotLatencyTracker::Get().Reset();
+	}));
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EShotLatencyStage : uint8
+{
+	Input,			// Fire input received, or auto fire timer fired
+	Fire,			// FireWeapon entered
+	MuzzleFX,		// Muzzle flash spawned
+	TraceResolved,	// Beam end location known
+	Rendered,		// Render thread finished the first frame containing the shot
+	Num
+};
+
+/*
+	Timestamps every shot from input to the first rendered frame and keeps a per stage latency histogram.
+	Each stage is also emitted as an Insights bookmark. Game thread only except for the render thread
+	completion, which is guarded by a critical section.
+*/
+class SHOOTERPROJESI_API FShooterShotLatencyTracker
+{
+public:
+	static FShooterShotLatencyTracker& Get();
+
+	// Called from the raw input binding, the next BeginShot measures from this time
+	void MarkInput();
+
+	// Starts tracking a shot, returns 0 when tracking is disabled
+	uint32 BeginShot();
+
+	void MarkStage(uint32 ShotId, EShotLatencyStage Stage);
+
+	// Game thread is done with the shot, it completes at the end of the render thread frame it is part of
+	void SubmitShot(uint32 ShotId);
+
+	// Logs the histogram and writes it to Saved/Profiling/ShotLatency.csv
+	void Dump() const;
+
+	void Reset();
+
+private:
+	FShooterShotLatencyTracker();
+
+	void OnEndFrameRenderThread();
+
+	void RecordCompletedShot(const double* StageTimes);
+
+	static const TCHAR* GetStageName(EShotLatencyStage Stage);
+
+	static constexpr int32 NumStages = static_cast<int32>(EShotLatencyStage::Num);
+
+	// 1 ms buckets, last bucket collects everything above
+	static constexpr int32 NumBuckets = 201;
+
+	struct FShotRecord
+	{
+		double StageTimes[NumStages];
+	};
+
+	mutable FCriticalSection Lock;
+
+	TMap<uint32, FShotRecord> InFlightShots;
+
+	// Shots the render thread has seen this frame
+	TArray<uint32> RenderThreadShots;
+
+	// Latency from Input to each stage
+	int32 Histograms[NumStages][NumBuckets];
+	int32 StageCounts[NumStages];
+	double StageTotalsMs[NumStages];
+	double StageMaxMs[NumStages];
+	int32 NumCompletedShots;
+
+	double PendingInputTime;
+	uint32 NextShotId;
+};
@@ -0,0 +1,226 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterStreamingPrefetchComponent.h"
+#include "ShooterProjesi.h"
+#include "ShooterTaskScheduler.h"
+#include "ShooterHitchDetector.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+#include "WorldPartition/WorldPartition.h"
+#include "WorldPartition/WorldPartitionSubsystem.h"
+#include "WorldPartition/WorldPartitionRuntimeCell.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Drone Streaming Stalls"), STAT_ShooterStreamingStalls, STATGROUP_Shooter);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Drone Streaming Stall Seconds"), STAT_ShooterStreamingStallSeconds, STATGROUP_Shooter);
+
+FShooterPrefetchSourceProvider::FShooterPrefetchSourceProvider(const UShooterStreamingPrefetchComponent* InComponent, int32 InSourceIndex, FName InSourceName)
+	: Component(InComponent)
+	, SourceIndex(InSourceIndex)
+	, SourceName(InSourceName)
+{
+}
+
+bool FShooterPrefetchSourceProvider::GetStreamingSource(FWorldPartitionStreamingSource& StreamingSource)
+{
+	return Component->GetPrefetchSource(SourceIndex, SourceName, StreamingSource);
+}
+
+// Sets default values for this component's properties
+UShooterStreamingPrefetchComponent::UShooterStreamingPrefetchComponent()
+{
+	// Stall checks run on the gameplay task scheduler
+	PrimaryComponentTick.bCanEverTick = false;
+
+	LookaheadTimes = { 0.5f, 1.5f, 3.f };
+	MinPrefetchSpeed = 300.f;
+	StallCheckRate = 10.f;
+
+	bPrefetchActive = false;
+	RangeLimit = 0.f;
+	StallTaskId = INDEX_NONE;
+	StallStartTime = -1.0;
+	ActiveStartTime = 0.0;
+	ActiveSeconds = 0.0;
+	NumStalls = 0;
+	TotalStallSeconds = 0.0;
+	MaxStallSeconds = 0.0;
+}
+
+void UShooterStreamingPrefetchComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	SetPrefetchActive(false);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UShooterStreamingPrefetchComponent::SetPrefetchActive(bool bNewActive)
+{
+	UWorld* World = GetWorld();
+	UWorldPartitionSubsystem* WorldPartition = World ? World->GetSubsystem<UWorldPartitionSubsystem>() : nullptr;
+	if (bPrefetchActive == bNewActive || WorldPartition == nullptr || World->GetWorldPartition() == nullptr || GetOwner() == nullptr)
+	{
+		return;
+	}
+	bPrefetchActive = bNewActive;
+	UShooterTaskSchedulerSubsystem* Scheduler = World->GetSubsystem<UShooterTaskSchedulerSubsystem>();
+
+	if (bPrefetchActive)
+	{
+		// Providers are made once and kept for the next activation
+		if (Providers.Num() == 0)
+		{
+			for (int32 SourceIndex = 0; SourceIndex <= LookaheadTimes.Num(); ++SourceIndex)
+			{
+				const FName SourceName(*FString::Printf(TEXT("%s_Prefetch%d"), *GetOwner()->GetName(), SourceIndex));
+				Providers.Add(MakeUnique<FShooterPrefetchSourceProvider>(this, SourceIndex, SourceName));
+			}
+		}
+		for (const TUniquePtr<FShooterPrefetchSourceProvider>& Provider : Providers)
+		{
+			WorldPartition->RegisterStreamingSourceProvider(Provider.Get());
+		}
+		if (Scheduler)
+		{
+			StallTaskId = Scheduler->RegisterTask(FName("StreamingStallCheck"), EShooterTaskPriority::Low, StallCheckRate,
+				FShooterScheduledTaskDelegate::CreateUObject(this, &UShooterStreamingPrefetchComponent::CheckStreamingStall), GetOwner());
+		}
+		ActiveStartTime = FPlatformTime::Seconds();
+	}
+	else
+	{
+		for (const TUniquePtr<FShooterPrefetchSourceProvider>& Provider : Providers)
+		{
+			WorldPartition->UnregisterStreamingSourceProvider(Provider.Get());
+		}
+		if (Scheduler)
+		{
+			Scheduler->UnregisterTask(StallTaskId);
+		}
+		StallTaskId = INDEX_NONE;
+		EndStall();
+		ActiveSeconds += FPlatformTime::Seconds() - ActiveStartTime;
+	}
+}
+
+void UShooterStreamingPrefetchComponent::SetRangeLimit(const AActor* Anchor, float Range)
+{
+	RangeAnchor = Anchor;
+	RangeLimit = Range;
+}
+
+bool UShooterStreamingPrefetchComponent::GetPrefetchSource(int32 SourceIndex, FName SourceName, FWorldPartitionStreamingSource& OutSource) const
+{
+	const AActor* Owner = GetOwner();
+	if (!bPrefetchActive || Owner == nullptr)
+	{
+		return false;
+	}
+	const FVector Location = Owner->GetActorLocation();
+	OutSource.Name = SourceName;
+	OutSource.Rotation = Owner->GetActorRotation();
+	OutSource.bBlockOnSlowLoading = false;
+
+	if (SourceIndex == 0)
+	{
+		OutSource.Location = Location;
+		OutSource.TargetState = EStreamingSourceTargetState::Activated;
+		OutSource.Priority = EStreamingSourcePriority::Highest;
+		return true;
+	}
+
+	const FVector Velocity = Owner->GetVelocity();
+	const float Speed = Velocity.Size();
+	if (!LookaheadTimes.IsValidIndex(SourceIndex - 1) || Speed < MinPrefetchSpeed)
+	{
+		return false;
+	}
+	FVector Point = Location + Velocity * LookaheadTimes[SourceIndex - 1];
+	const AActor* Anchor = RangeAnchor.Get();
+	if (Anchor && RangeLimit > 0.f)
+	{
+		const FVector AnchorLocation = Anchor->GetActorLocation();
+		Point = AnchorLocation + (Point - AnchorLocation).GetClampedToMaxSize(RangeLimit);
+	}
+
+	// Loaded only, the source at the owner activates the cells once it gets there
+	OutSource.Location = Point;
+	OutSource.TargetState = EStreamingSourceTargetState::Loaded;
+
+	// Sooner arrival streams first, Highest is kept for the owner's own location
+	const float MaxLookaheadTime = FMath::Max(LookaheadTimes.Last(), KINDA_SMALL_NUMBER);
+	const float ArrivalAlpha = FMath::Clamp(FVector::Dist(Location, Point) / Speed / MaxLookaheadTime, 0.f, 1.f);
+	const float Priority = FMath::Lerp(static_cast<float>(EStreamingSourcePriority::High), static_cast<float>(EStreamingSourcePriority::Lowest), ArrivalAlpha);
+	OutSource.Priority = static_cast<EStreamingSourcePriority>(FMath::RoundToInt(Priority));
+	return true;
+}
+
+void UShooterStreamingPrefetchComponent::CheckStreamingStall(float DeltaTime)
+{
+	const UWorldPartitionSubsystem* WorldPartition = GetWorld()->GetSubsystem<UWorldPartitionSubsystem>();
+	const AActor* Owner = GetOwner();
+	if (WorldPartition == nullptr || Owner == nullptr)
+	{
+		return;
+	}
+
+	TArray<FWorldPartitionStreamingQuerySource> QuerySources;
+	FWorldPartitionStreamingQuerySource& QuerySource = QuerySources.AddDefaulted_GetRef();
+	QuerySource.Location = Owner->GetActorLocation();
+	QuerySource.bUseGridLoadingRange = true;
+	const bool bStalled = !WorldPartition->IsStreamingCompleted(EWorldPartitionRuntimeCellState::Activated, QuerySources, false);
+
+	if (bStalled && StallStartTime < 0.0)
+	{
+		StallStartTime = FPlatformTime::Seconds();
+		++NumStalls;
+		INC_DWORD_STAT(STAT_ShooterStreamingStalls);
+		SHOOTER_HITCH_EVENT("StreamingStall");
+	}
+	else if (!bStalled)
+	{
+		EndStall();
+	}
+}
+
+void UShooterStreamingPrefetchComponent::EndStall()
+{
+	if (StallStartTime < 0.0)
+	{
+		return;
+	}
+	const double StallSeconds = FPlatformTime::Seconds() - StallStartTime;
+	StallStartTime = -1.0;
+	TotalStallSeconds += StallSeconds;
+	MaxStallSeconds = FMath::Max(MaxStallSeconds, StallSeconds);
+	INC_FLOAT_STAT_BY(STAT_ShooterStreamingStallSeconds, StallSeconds);
+	UE_LOG(LogShooter, Verbose, TEXT("%s waited %.2f s for streaming"), *GetNameSafe(GetOwner()), StallSeconds);
+}
+
+void UShooterStreamingPrefetchComponent::LogStats() const
+{
+	const double Active = ActiveSeconds + (bPrefetchActive ? FPlatformTime::Seconds() - ActiveStartTime : 0.0);
+	UE_LOG(LogShooter, Display, TEXT("%s: active %.1f s, %d stalls, stalled %.2f s (%.1f%%), longest %.2f s"),
+		*GetNameSafe(GetOwner()),
+		Active,
+		NumStalls,
+		TotalStallSeconds,
+		Active > 0.0 ? TotalStallSeconds / Active * 100.0 : 0.0,
+		MaxStallSeconds);
+}
+
+static FAutoConsoleCommandWithWorld StreamingStatsCommand(
+	TEXT("Shooter.Streaming.Stats"),
+	TEXT("Logs streaming stalls of every prefetching actor, e.g. flown drones"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		for (TObjectIterator<UShooterStreamingPrefetchComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == World && !It->IsTemplate())
+			{
+				It->LogStats();
+			}
+		}
+	}));
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "WorldPartition/WorldPartitionStreamingSource.h"
+#include "ShooterStreamingPrefetchComponent.generated.h"
+
+class UShooterStreamingPrefetchComponent;
+
+// One streaming source of a prefetch component, a provider reports a single source
+class FShooterPrefetchSourceProvider : public IWorldPartitionStreamingSourceProvider
+{
+public:
+	FShooterPrefetchSourceProvider(const UShooterStreamingPrefetchComponent* InComponent, int32 InSourceIndex, FName InSourceName);
+
+	virtual bool GetStreamingSource(FWorldPartitionStreamingSource& StreamingSource) override;
+
+private:
+	const UShooterStreamingPrefetchComponent* Component;
+	int32 SourceIndex;
+	FName SourceName;
+};
+
+/*
+	World partition streaming for an owner that moves faster than the player's streaming source keeps up with.
+	Besides the owner's location, sources are placed along its velocity at LookaheadTimes and load cells ahead of it,
+	the sooner the owner arrives at a source the higher its priority. Sources only exist while the prefetch is active.
+	Also watches for stalls, time the cells around the owner are not activated yet, reported by Shooter.Streaming.Stats.
+*/
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class SHOOTERPROJESI_API UShooterStreamingPrefetchComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UShooterStreamingPrefetchComponent();
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Registers the streaming sources and the stall check, does nothing in worlds without world partition
+	void SetPrefetchActive(bool bNewActive);
+
+	FORCEINLINE bool IsPrefetchActive() const { return bPrefetchActive; }
+
+	// Lookahead sources are kept within Range of Anchor, the owner can't get further anyway. Null anchor for no limit
+	void SetRangeLimit(const AActor* Anchor, float Range);
+
+	// Source 0 is the owner's location, the others the lookahead points. False while the source has nothing to load
+	bool GetPrefetchSource(int32 SourceIndex, FName SourceName, FWorldPartitionStreamingSource& OutSource) const;
+
+	void LogStats() const;
+
+private:
+	// Scheduled at StallCheckRate while active
+	void CheckStreamingStall(float DeltaTime);
+
+	void EndStall();
+
+	// Seconds ahead along the owner's velocity a source is placed at
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (AllowPrivateAccess = "true"))
+	TArray<float> LookaheadTimes;
+
+	// Below this speed only the owner's location streams
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (AllowPrivateAccess = "true"))
+	float MinPrefetchSpeed;
+
+	// Times per second the cells around the owner are checked
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (AllowPrivateAccess = "true"))
+	float StallCheckRate;
+
+	TArray<TUniquePtr<FShooterPrefetchSourceProvider>> Providers;
+
+	bool bPrefetchActive;
+
+	TWeakObjectPtr<const AActor> RangeAnchor;
+	float RangeLimit;
+
+	int32 StallTaskId;
+
+	// Negative while not stalled
+	double StallStartTime;
+
+	double ActiveStartTime;
+	double ActiveSeconds;
+	int32 NumStalls;
+	double TotalStallSeconds;
+	double MaxStallSeconds;
+};
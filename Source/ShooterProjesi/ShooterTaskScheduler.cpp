@@ -0,0 +1,242 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterTaskScheduler.h"
+#include "ShooterProjesi.h"
+#include "ShooterHitchDetector.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarSchedulerBudgetMs(
+	TEXT("Shooter.Scheduler.BudgetMs"),
+	1.f,
+	TEXT("Game thread milliseconds per frame for scheduled gameplay tasks, critical tasks ignore it"));
+
+static TAutoConsoleVariable<int32> CVarSchedulerMaxDeferredFrames(
+	TEXT("Shooter.Scheduler.MaxDeferredFrames"),
+	8,
+	TEXT("Frames in a row a task may be deferred before it runs regardless of the budget"));
+
+DECLARE_CYCLE_STAT(TEXT("Scheduled Tasks"), STAT_ShooterScheduledTasks, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scheduled Tasks Run"), STAT_ShooterScheduledTasksRun, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scheduled Tasks Deferred"), STAT_ShooterScheduledTasksDeferred, STATGROUP_Shooter);
+
+namespace ShooterTaskScheduler
+{
+	static const TCHAR* GetPriorityName(EShooterTaskPriority Priority)
+	{
+		switch (Priority)
+		{
+		case EShooterTaskPriority::Critical: return TEXT("Critical");
+		case EShooterTaskPriority::High: return TEXT("High");
+		case EShooterTaskPriority::Normal: return TEXT("Normal");
+		case EShooterTaskPriority::Low: return TEXT("Low");
+		default: return TEXT("Unknown");
+		}
+	}
+}
+
+UShooterTaskSchedulerSubsystem::UShooterTaskSchedulerSubsystem()
+{
+	NextTaskId = 0;
+	bRunningTasks = false;
+	bHasRemovedTasks = false;
+	NumFrames = 0;
+	NumOverrunFrames = 0;
+	MaxFrameMs = 0.0;
+}
+
+void UShooterTaskSchedulerSubsystem::Deinitialize()
+{
+	Tasks.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId UShooterTaskSchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterTaskSchedulerSubsystem, STATGROUP_Tickables);
+}
+
+int32 UShooterTaskSchedulerSubsystem::RegisterTask(FName Name, EShooterTaskPriority Priority, float Frequency, FShooterScheduledTaskDelegate Delegate, const AActor* Owner)
+{
+	FScheduledTask& Task = Tasks.AddDefaulted_GetRef();
+	Task.Id = NextTaskId++;
+	Task.Name = Name;
+	Task.Priority = Priority;
+	Task.Interval = Frequency > 0.f ? 1.f / Frequency : 0.f;
+	Task.Delegate = MoveTemp(Delegate);
+	Task.Owner = Owner;
+	Task.bHasOwner = Owner != nullptr;
+	// Spread tasks registered in the same frame over their first interval
+	Task.NextRunTime = GetWorld()->GetTimeSeconds() + FMath::FRand() * Task.Interval;
+	return Task.Id;
+}
+
+void UShooterTaskSchedulerSubsystem::UnregisterTask(int32 TaskId)
+{
+	const int32 TaskIndex = Tasks.IndexOfByPredicate([TaskId](const FScheduledTask& Task) { return Task.Id == TaskId; });
+	if (TaskIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (bRunningTasks)
+	{
+		// Indices of the frame's due list must stay valid
+		Tasks[TaskIndex].Delegate.Unbind();
+		bHasRemovedTasks = true;
+	}
+	else
+	{
+		Tasks.RemoveAtSwap(TaskIndex);
+	}
+}
+
+void UShooterTaskSchedulerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_ShooterScheduledTasks);
+
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	const double BudgetSeconds = CVarSchedulerBudgetMs.GetValueOnGameThread() / 1000.0;
+	const int32 MaxDeferredFrames = CVarSchedulerMaxDeferredFrames.GetValueOnGameThread();
+
+	TArray<int32, TInlineAllocator<32>> DueTasks;
+	for (int32 TaskIndex = 0; TaskIndex < Tasks.Num(); ++TaskIndex)
+	{
+		const FScheduledTask& Task = Tasks[TaskIndex];
+		if (Task.Delegate.IsBound() && WorldTime >= Task.NextRunTime)
+		{
+			DueTasks.Add(TaskIndex);
+		}
+	}
+
+	// Higher priority first, the longest waiting task first within a priority
+	DueTasks.Sort([this, MaxDeferredFrames](int32 A, int32 B)
+	{
+		const FScheduledTask& TaskA = Tasks[A];
+		const FScheduledTask& TaskB = Tasks[B];
+		const EShooterTaskPriority PriorityA = TaskA.DeferredFrames >= MaxDeferredFrames ? EShooterTaskPriority::Critical : TaskA.Priority;
+		const EShooterTaskPriority PriorityB = TaskB.DeferredFrames >= MaxDeferredFrames ? EShooterTaskPriority::Critical : TaskB.Priority;
+		if (PriorityA != PriorityB)
+		{
+			return PriorityA < PriorityB;
+		}
+		return TaskA.NextRunTime < TaskB.NextRunTime;
+	});
+
+	const double FrameStartTime = FPlatformTime::Seconds();
+	int32 NumRun = 0;
+	int32 NumDeferred = 0;
+	bRunningTasks = true;
+	for (const int32 TaskIndex : DueTasks)
+	{
+		FScheduledTask& Task = Tasks[TaskIndex];
+		const bool bMustRun = Task.Priority == EShooterTaskPriority::Critical || Task.DeferredFrames >= MaxDeferredFrames;
+		const bool bOverBudget = FPlatformTime::Seconds() - FrameStartTime >= BudgetSeconds;
+		if (bOverBudget && !bMustRun)
+		{
+			++Task.DeferredFrames;
+			++Task.NumDeferred;
+			++NumDeferred;
+			continue;
+		}
+
+		if (bOverBudget)
+		{
+			++Task.NumOverruns;
+		}
+		RunTask(TaskIndex, WorldTime);
+		++NumRun;
+	}
+	bRunningTasks = false;
+
+	if (bHasRemovedTasks)
+	{
+		Tasks.RemoveAllSwap([](const FScheduledTask& Task) { return !Task.Delegate.IsBound(); });
+		bHasRemovedTasks = false;
+	}
+
+	const double FrameMs = (FPlatformTime::Seconds() - FrameStartTime) * 1000.0;
+	if (NumRun > 0)
+	{
+		++NumFrames;
+		MaxFrameMs = FMath::Max(MaxFrameMs, FrameMs);
+		if (FrameMs > BudgetSeconds * 1000.0)
+		{
+			++NumOverrunFrames;
+			UE_LOG(LogShooter, Verbose, TEXT("Scheduled tasks took %.3f ms, budget %.3f ms, %d deferred"), FrameMs, BudgetSeconds * 1000.0, NumDeferred);
+		}
+	}
+	SET_DWORD_STAT(STAT_ShooterScheduledTasksRun, NumRun);
+	SET_DWORD_STAT(STAT_ShooterScheduledTasksDeferred, NumDeferred);
+	FShooterHitchDetector& HitchDetector = FShooterHitchDetector::Get();
+	HitchDetector.RecordTiming(TEXT("ScheduledTasks"), FrameStartTime, FrameStartTime + FrameMs / 1000.0);
+	HitchDetector.AddCounter(TEXT("ScheduledTasksRun"), NumRun);
+	HitchDetector.AddCounter(TEXT("ScheduledTasksDeferred"), NumDeferred);
+}
+
+void UShooterTaskSchedulerSubsystem::RunTask(int32 TaskIndex, double WorldTime)
+{
+	FScheduledTask& Task = Tasks[TaskIndex];
+
+	const AActor* Owner = Task.Owner.Get();
+	if (Task.bHasOwner && Owner == nullptr)
+	{
+		Task.Delegate.Unbind(); // Owner is gone without unregistering
+		bHasRemovedTasks = true;
+		return;
+	}
+
+	float DeltaTime = Task.LastRunTime >= 0.0 ? static_cast<float>(WorldTime - Task.LastRunTime) : GetWorld()->GetDeltaSeconds();
+	if (Owner)
+	{
+		DeltaTime *= Owner->CustomTimeDilation;
+	}
+	Task.LastRunTime = WorldTime;
+	// A late task is not run again to catch up, the next run is one interval from now
+	Task.NextRunTime = WorldTime + Task.Interval;
+	Task.DeferredFrames = 0;
+
+	const double StartTime = FPlatformTime::Seconds();
+	// The task may register new tasks and reallocate Tasks, copy the delegate first
+	const FShooterScheduledTaskDelegate Delegate = Task.Delegate;
+	Delegate.ExecuteIfBound(DeltaTime);
+	const double TaskMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	FScheduledTask& RanTask = Tasks[TaskIndex];
+	++RanTask.NumRuns;
+	RanTask.TotalMs += TaskMs;
+	RanTask.MaxMs = FMath::Max(RanTask.MaxMs, TaskMs);
+}
+
+void UShooterTaskSchedulerSubsystem::LogStats() const
+{
+	UE_LOG(LogShooter, Display, TEXT("Scheduler: %d tasks, %llu of %llu frames over the %.2f ms budget, worst frame %.3f ms"),
+		Tasks.Num(), NumOverrunFrames, NumFrames, CVarSchedulerBudgetMs.GetValueOnGameThread(), MaxFrameMs);
+	for (const FScheduledTask& Task : Tasks)
+	{
+		UE_LOG(LogShooter, Display, TEXT("  %-28s %-8s %6.1f Hz  runs %8llu  deferred %6llu  forced over budget %6llu  avg %.3f ms  max %.3f ms"),
+			*Task.Name.ToString(),
+			ShooterTaskScheduler::GetPriorityName(Task.Priority),
+			Task.Interval > 0.f ? 1.f / Task.Interval : 0.f,
+			Task.NumRuns,
+			Task.NumDeferred,
+			Task.NumOverruns,
+			Task.NumRuns > 0 ? Task.TotalMs / Task.NumRuns : 0.0,
+			Task.MaxMs);
+	}
+}
+
+static FAutoConsoleCommandWithWorld SchedulerStatsCommand(
+	TEXT("Shooter.Scheduler.Stats"),
+	TEXT("Logs scheduled gameplay tasks with their run, deferral and overrun counts"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UShooterTaskSchedulerSubsystem* Scheduler = World ? World->GetSubsystem<UShooterTaskSchedulerSubsystem>() : nullptr)
+		{
+			Scheduler->LogStats();
+		}
+	}));
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterTaskScheduler.generated.h"
+
+enum class EShooterTaskPriority : uint8
+{
+	Critical,	// Runs whenever due, even over budget
+	High,
+	Normal,
+	Low
+};
+
+// Receives the time since the task last ran, scaled by the owner's CustomTimeDilation
+DECLARE_DELEGATE_OneParam(FShooterScheduledTaskDelegate, float /*DeltaTime*/);
+
+/*
+	Time sliced gameplay work. Systems register tasks with a priority and a desired frequency, each frame the due tasks run
+	in priority order until Shooter.Scheduler.BudgetMs is used up. Tasks that don't fit are deferred to the next frame with
+	their lateness counted towards their order, and a task deferred Shooter.Scheduler.MaxDeferredFrames in a row runs anyway.
+	Frames going over budget are counted per task and reported by Shooter.Scheduler.Stats.
+*/
+UCLASS()
+class SHOOTERPROJESI_API UShooterTaskSchedulerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UShooterTaskSchedulerSubsystem();
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/*
+		Registers a task, returns its id for UnregisterTask
+		@param Frequency Runs per second, 0 runs it every frame
+		@param Owner Its CustomTimeDilation scales the task's DeltaTime like an actor tick
+	*/
+	int32 RegisterTask(FName Name, EShooterTaskPriority Priority, float Frequency, FShooterScheduledTaskDelegate Delegate, const AActor* Owner = nullptr);
+
+	// Safe to call from inside a task
+	void UnregisterTask(int32 TaskId);
+
+	void LogStats() const;
+
+private:
+	struct FScheduledTask
+	{
+		int32 Id = INDEX_NONE;
+		FName Name;
+		EShooterTaskPriority Priority = EShooterTaskPriority::Normal;
+		float Interval = 0.f;
+		FShooterScheduledTaskDelegate Delegate;
+		TWeakObjectPtr<const AActor> Owner;
+		bool bHasOwner = false;
+
+		double LastRunTime = -1.0;
+		double NextRunTime = 0.0;
+
+		// Frames in a row this task was due but didn't fit in the budget
+		int32 DeferredFrames = 0;
+
+		uint64 NumRuns = 0;
+		uint64 NumDeferred = 0;
+		uint64 NumOverruns = 0;
+		double TotalMs = 0.0;
+		double MaxMs = 0.0;
+	};
+
+	void RunTask(int32 TaskIndex, double WorldTime);
+
+	TArray<FScheduledTask> Tasks;
+
+	int32 NextTaskId;
+
+	// Unregistered while the scheduler was running tasks, removed after the frame
+	bool bRunningTasks;
+	bool bHasRemovedTasks;
+
+	uint64 NumFrames;
+	uint64 NumOverrunFrames;
+	double MaxFrameMs;
+};
@@ -0,0 +1,234 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterTimeDilationSubsystem.h"
+#include "ShooterProjesi.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "RenderCore.h"
+
+DECLARE_CYCLE_STAT(TEXT("Time Dilation Refresh"), STAT_ShooterTimeDilationRefresh, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dilated Actors"), STAT_ShooterDilatedActors, STATGROUP_Shooter);
+
+UShooterTimeDilationSubsystem::UShooterTimeDilationSubsystem()
+{
+	NextScopeId = 0;
+	RegionRefreshInterval = 0.2f;
+	TimeSinceRegionRefresh = 0.f;
+
+	TotalRefreshMs = 0.0;
+	NumRefreshes = 0;
+	GameThreadMsWithScopes = 0.0;
+	FramesWithScopes = 0;
+	GameThreadMsWithoutScopes = 0.0;
+	FramesWithoutScopes = 0;
+}
+
+void UShooterTimeDilationSubsystem::Deinitialize()
+{
+	Scopes.Reset();
+	ApplyScopes(); // Restore everything we touched
+
+	Super::Deinitialize();
+}
+
+TStatId UShooterTimeDilationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterTimeDilationSubsystem, STATGROUP_Tickables);
+}
+
+int32 UShooterTimeDilationSubsystem::AddActorScope(const TArray<AActor*>& Actors, float Dilation)
+{
+	FDilationScope& Scope = Scopes.AddDefaulted_GetRef();
+	Scope.Id = NextScopeId++;
+	Scope.Dilation = Dilation;
+	for (AActor* Actor : Actors)
+	{
+		Scope.Actors.Add(Actor);
+	}
+	const int32 ScopeId = Scope.Id;
+
+	ApplyScopes();
+	return ScopeId;
+}
+
+int32 UShooterTimeDilationSubsystem::AddRegionScope(AActor* Anchor, float Radius, float Dilation)
+{
+	FDilationScope& Scope = Scopes.AddDefaulted_GetRef();
+	Scope.Id = NextScopeId++;
+	Scope.Dilation = Dilation;
+	Scope.Anchor = Anchor;
+	Scope.Radius = Radius;
+	Scope.bIsRegion = true;
+	RefreshRegion(Scope);
+	const int32 ScopeId = Scope.Id;
+
+	ApplyScopes();
+	return ScopeId;
+}
+
+void UShooterTimeDilationSubsystem::RemoveScope(int32 ScopeId)
+{
+	const int32 NumRemoved = Scopes.RemoveAll([ScopeId](const FDilationScope& Scope) { return Scope.Id == ScopeId; });
+	if (NumRemoved > 0)
+	{
+		ApplyScopes();
+	}
+}
+
+void UShooterTimeDilationSubsystem::RefreshRegion(FDilationScope& Scope)
+{
+	Scope.RegionMembers.Reset();
+
+	AActor* Anchor = Scope.Anchor.Get();
+	if (Anchor == nullptr)
+	{
+		return;
+	}
+	// Anchor is always affected, even if it has no collision
+	Scope.RegionMembers.Add(Anchor);
+
+	FCollisionObjectQueryParams ObjectParams;
+	ObjectParams.AddObjectTypesToQuery(ECollisionChannel::ECC_Pawn);
+	ObjectParams.AddObjectTypesToQuery(ECollisionChannel::ECC_PhysicsBody);
+	ObjectParams.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldDynamic);
+
+	TArray<FOverlapResult> Overlaps;
+	GetWorld()->OverlapMultiByObjectType(Overlaps, Anchor->GetActorLocation(), FQuat::Identity, ObjectParams, FCollisionShape::MakeSphere(Scope.Radius));
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		AActor* Actor = Overlap.GetActor();
+		if (Actor && Actor != Anchor)
+		{
+			Scope.RegionMembers.AddUnique(Actor);
+		}
+	}
+}
+
+void UShooterTimeDilationSubsystem::ApplyScopes()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterTimeDilationRefresh);
+
+	// Slowest scope wins for actors in more than one scope
+	TMap<AActor*, float> DesiredDilations;
+	for (const FDilationScope& Scope : Scopes)
+	{
+		const TArray<TWeakObjectPtr<AActor>>& Members = Scope.bIsRegion ? Scope.RegionMembers : Scope.Actors;
+		for (const TWeakObjectPtr<AActor>& Member : Members)
+		{
+			if (AActor* Actor = Member.Get())
+			{
+				float& Dilation = DesiredDilations.FindOrAdd(Actor, Scope.Dilation);
+				Dilation = FMath::Min(Dilation, Scope.Dilation);
+			}
+		}
+	}
+
+	// Restore actors that left every scope
+	for (auto It = OriginalDilations.CreateIterator(); It; ++It)
+	{
+		AActor* Actor = It.Key().Get();
+		if (Actor == nullptr)
+		{
+			It.RemoveCurrent();
+		}
+		else if (!DesiredDilations.Contains(Actor))
+		{
+			SetActorDilation(Actor, It.Value());
+			It.RemoveCurrent();
+		}
+	}
+
+	// Dilate actors in a scope, remembering their original value the first time
+	for (const TPair<AActor*, float>& Desired : DesiredDilations)
+	{
+		const float& Original = OriginalDilations.FindOrAdd(Desired.Key, Desired.Key->CustomTimeDilation);
+		SetActorDilation(Desired.Key, Original * Desired.Value);
+	}
+
+	SET_DWORD_STAT(STAT_ShooterDilatedActors, OriginalDilations.Num());
+}
+
+void UShooterTimeDilationSubsystem::SetActorDilation(AActor* Actor, float NewDilation)
+{
+	const float OldDilation = Actor->CustomTimeDilation;
+	if (FMath::IsNearlyEqual(OldDilation, NewDilation))
+	{
+		return;
+	}
+	Actor->CustomTimeDilation = NewDilation;
+
+	if (IShooterTimeDilationListener* Listener = Cast<IShooterTimeDilationListener>(Actor))
+	{
+		Listener->OnCustomTimeDilationChanged(OldDilation, NewDilation);
+	}
+}
+
+void UShooterTimeDilationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Tick cost of the previous frame, split by whether slow motion was active
+	const double GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	if (Scopes.Num() > 0)
+	{
+		GameThreadMsWithScopes += GameThreadMs;
+		++FramesWithScopes;
+	}
+	else
+	{
+		GameThreadMsWithoutScopes += GameThreadMs;
+		++FramesWithoutScopes;
+		return;
+	}
+
+	TimeSinceRegionRefresh += DeltaTime;
+	if (TimeSinceRegionRefresh < RegionRefreshInterval)
+	{
+		return;
+	}
+	TimeSinceRegionRefresh = 0.f;
+
+	bool bHasRegions = false;
+	const double StartTime = FPlatformTime::Seconds();
+	for (FDilationScope& Scope : Scopes)
+	{
+		if (Scope.bIsRegion)
+		{
+			RefreshRegion(Scope);
+			bHasRegions = true;
+		}
+	}
+	if (bHasRegions)
+	{
+		ApplyScopes();
+		TotalRefreshMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		++NumRefreshes;
+	}
+}
+
+void UShooterTimeDilationSubsystem::LogStats() const
+{
+	UE_LOG(LogShooter, Display, TEXT("Time dilation: %d scopes, %d dilated actors, avg region refresh %.3f ms over %d refreshes"),
+		Scopes.Num(),
+		OriginalDilations.Num(),
+		NumRefreshes > 0 ? TotalRefreshMs / NumRefreshes : 0.0,
+		NumRefreshes);
+	UE_LOG(LogShooter, Display, TEXT("Time dilation: avg game thread %.3f ms with scopes (%d frames), %.3f ms without (%d frames)"),
+		FramesWithScopes > 0 ? GameThreadMsWithScopes / FramesWithScopes : 0.0,
+		FramesWithScopes,
+		FramesWithoutScopes > 0 ? GameThreadMsWithoutScopes / FramesWithoutScopes : 0.0,
+		FramesWithoutScopes);
+}
+
+static FAutoConsoleCommandWithWorld TimeDilationStatsCommand(
+	TEXT("Shooter.TimeDilation.Stats"),
+	TEXT("Logs scoped time dilation refresh cost and game thread time while slow motion is active"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UShooterTimeDilationSubsystem* Subsystem = World ? World->GetSubsystem<UShooterTimeDilationSubsystem>() : nullptr)
+		{
+			Subsystem->LogStats();
+		}
+	}));
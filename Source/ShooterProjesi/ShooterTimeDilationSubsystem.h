@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterTimeDilationSubsystem.generated.h"
+
+UINTERFACE(MinimalAPI)
+class UShooterTimeDilationListener : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/*
+	Implemented by actors that own world timers. World timers don't follow CustomTimeDilation,
+	so the actor rescales its pending timers when the subsystem changes its dilation.
+*/
+class SHOOTERPROJESI_API IShooterTimeDilationListener
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnCustomTimeDilationChanged(float OldDilation, float NewDilation) = 0;
+};
+
+/*
+	Applies CustomTimeDilation to selected actors or to every actor inside a region instead of dilating the whole world.
+	Actors outside every scope, other players on a server included, keep running at full rate.
+	When scopes overlap the slowest dilation wins. Physics bodies are not affected by CustomTimeDilation.
+*/
+UCLASS()
+class SHOOTERPROJESI_API UShooterTimeDilationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UShooterTimeDilationSubsystem();
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	// Dilates the given actors until the returned scope is removed
+	int32 AddActorScope(const TArray<AActor*>& Actors, float Dilation);
+
+	// Dilates every pawn and dynamic body within Radius of Anchor, membership is refreshed while the scope lives
+	int32 AddRegionScope(AActor* Anchor, float Radius, float Dilation);
+
+	// Restores dilation of every actor only this scope was affecting
+	void RemoveScope(int32 ScopeId);
+
+	FORCEINLINE bool HasActiveScopes() const { return Scopes.Num() > 0; }
+
+	// Logs refresh cost, dilated actor count and game thread time with and without active scopes
+	void LogStats() const;
+
+private:
+	struct FDilationScope
+	{
+		int32 Id = INDEX_NONE;
+		float Dilation = 1.f;
+
+		// Actor scopes
+		TArray<TWeakObjectPtr<AActor>> Actors;
+
+		// Region scopes
+		TWeakObjectPtr<AActor> Anchor;
+		float Radius = 0.f;
+		bool bIsRegion = false;
+		TArray<TWeakObjectPtr<AActor>> RegionMembers;
+	};
+
+	// Re-queries region members
+	void RefreshRegion(FDilationScope& Scope);
+
+	// Computes the dilation of every affected actor and applies the changes
+	void ApplyScopes();
+
+	static void SetActorDilation(AActor* Actor, float NewDilation);
+
+	TArray<FDilationScope> Scopes;
+
+	// Actors currently dilated by us and their dilation before that
+	TMap<TWeakObjectPtr<AActor>, float> OriginalDilations;
+
+	int32 NextScopeId;
+
+	// Seconds between region membership queries
+	float RegionRefreshInterval;
+
+	float TimeSinceRegionRefresh;
+
+	// Measurements
+	double TotalRefreshMs;
+	int32 NumRefreshes;
+	double GameThreadMsWithScopes;
+	int32 FramesWithScopes;
+	double GameThreadMsWithoutScopes;
+	int32 FramesWithoutScopes;
+};
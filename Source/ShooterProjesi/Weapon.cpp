@@ -1,5 +1,68 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "Weapon.h"
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Weapon.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMeshSocket.h"
+
+bool FShooterSocketHandle::Resolve(const USkeletalMeshComponent* Mesh, FName SocketName)
+{
+	BoneIndex = INDEX_NONE;
+	const USkeletalMeshSocket* Socket = Mesh ? Mesh->GetSocketByName(SocketName) : nullptr;
+	if (Socket)
+	{
+		BoneIndex = Mesh->GetBoneIndex(Socket->BoneName);
+		LocalTransform = Socket->GetSocketLocalTransform();
+	}
+	return IsValid();
+}
+
+FTransform FShooterSocketHandle::GetWorldTransform(const USkeletalMeshComponent* Mesh) const
+{
+	return LocalTransform * Mesh->GetBoneTransform(BoneIndex);
+}
+
+AWeapon::AWeapon()
+{
+	MuzzleSocketName = FName("BarrelSocket");
+	GripSocketName = FName("GripSocket");
+}
+
+void AWeapon::Equip(USkeletalMeshComponent* CharacterMesh, FName HandSocketName)
+{
+	AttachToComponent(CharacterMesh, FAttachmentTransformRules::SnapToTargetNotIncludingScale, HandSocketName);
+
+	// Offset the weapon so its grip sits in the hand
+	USkeletalMeshComponent* WeaponMesh = GetItemMesh();
+	if (WeaponMesh->DoesSocketExist(GripSocketName))
+	{
+		SetActorRelativeTransform(WeaponMesh->GetSocketTransform(GripSocketName, RTS_Component).Inverse());
+	}
+
+	SetItemState(EItemState::EIS_Equipped);
+	MuzzleSocket.Resolve(WeaponMesh, MuzzleSocketName);
+}
+
+void AWeapon::Stow()
+{
+	SetItemState(EItemState::EIS_Stowed);
+}
+
+void AWeapon::Drop(const FTransform& DropTransform)
+{
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	SetOwner(nullptr);
+	SetActorTransform(DropTransform);
+	MuzzleSocket = FShooterSocketHandle();
+	SetItemState(EItemState::EIS_Dropped);
+}
+
+bool AWeapon::GetMuzzleTransform(FTransform& OutTransform) const
+{
+	if (!MuzzleSocket.IsValid())
+	{
+		return false;
+	}
+	OutTransform = MuzzleSocket.GetWorldTransform(GetItemMesh());
+	return true;
+}
@@ -1,17 +1,59 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Item.h"
-#include "Weapon.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class SHOOTERPROJESI_API AWeapon : public AItem
-{
-	GENERATED_BODY()
-	
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Item.h"
+#include "Weapon.generated.h"
+
+class USkeletalMeshComponent;
+
+// Bone index and bone relative transform of a skeletal mesh socket, resolved once so per shot code does no name lookups
+struct SHOOTERPROJESI_API FShooterSocketHandle
+{
+	int32 BoneIndex = INDEX_NONE;
+
+	FTransform LocalTransform;
+
+	bool Resolve(const USkeletalMeshComponent* Mesh, FName SocketName);
+
+	FORCEINLINE bool IsValid() const { return BoneIndex != INDEX_NONE; }
+
+	// Socket transform from the mesh's current world space bone transform
+	FTransform GetWorldTransform(const USkeletalMeshComponent* Mesh) const;
+};
+
+/**
+ * Weapon held by a shooter character. Characters keep a small pool of spawned weapons, swapping only attaches,
+ * stows and drops them.
+ */
+UCLASS()
+class SHOOTERPROJESI_API AWeapon : public AItem
+{
+	GENERATED_BODY()
+
+public:
+	AWeapon();
+
+	// Attaches the grip to HandSocketName of CharacterMesh and resolves the muzzle socket
+	void Equip(USkeletalMeshComponent* CharacterMesh, FName HandSocketName);
+
+	// Stays attached to its owner but is hidden and stops updating until equipped again
+	void Stow();
+
+	// Detaches from its owner and lies at DropTransform
+	void Drop(const FTransform& DropTransform);
+
+	// Muzzle socket world transform from the socket resolved at equip time
+	bool GetMuzzleTransform(FTransform& OutTransform) const;
+
+private:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	FName MuzzleSocketName;
+
+	// Socket lined up with the character's hand, the weapon root is used without it
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	FName GripSocketName;
+
+	FShooterSocketHandle MuzzleSocket;
+};